@@ -19,9 +19,16 @@
 #include <functional>
 #include <deque>
 #include <random>
+#include <bit>
+#include <type_traits>
 using namespace std;
 
 #include "aurora_hal.hpp"
+#include "src/fec/AuroraXorKernels.hpp"
+#include "src/fec/AuroraLtNeighbours.hpp"
+#include "src/fec/AuroraWorkerPool.hpp"
+#include "src/fec/AuroraGf256.hpp"
+#include "src/fec/AuroraSlidingWindow.hpp"
 #ifdef _WIN32
 #undef byte
 #endif
@@ -45,46 +52,730 @@ namespace CRYPTO {
 
 // ===== Fountain / LT-based FEC =====
 namespace fec {
-  struct Fp{ uint32_t seed, deg; vector<uint8_t> data; };
+  // Vista non proprietaria sui byte di un simbolo. I byte vivono in una SymbolSlab che deve
+  // sopravvivere a tutti i Fp/Pkt che la referenziano: copiare un Pkt non copia il payload.
+  struct SymView{
+    const uint8_t* p=nullptr; uint32_t n=0;
+    const uint8_t* data() const { return p; }
+    size_t size() const { return n; }
+    bool empty() const { return n==0; }
+    const uint8_t* begin() const { return p; }
+    const uint8_t* end() const { return p+n; }
+    const uint8_t& operator[](size_t i) const { return p[i]; }
+    vector<uint8_t> to_vector() const { return vector<uint8_t>(begin(), end()); }
+    friend bool operator==(SymView a, SymView b){ return a.n==b.n && (!a.n || memcmp(a.p, b.p, a.n)==0); }
+    friend bool operator==(SymView a, const vector<uint8_t>& b){ return a.n==b.size() && (!a.n || memcmp(a.p, b.data(), a.n)==0); }
+  };
+
+  // Storage dei simboli di un token: slot da S byte con stride multiplo della cache line,
+  // in chunk allineati che non vengono mai spostati o ridimensionati. Una allocazione per
+  // chunk (non per simbolo); le SymView restano valide anche se la slab viene spostata.
+  constexpr size_t SLAB_ALIGN=64;
+  class SymbolSlab{
+    struct AlignedFree{ void operator()(uint8_t* q) const { ::operator delete(q, std::align_val_t(SLAB_ALIGN)); } };
+    struct Chunk{ unique_ptr<uint8_t[], AlignedFree> mem; size_t cap=0, used=0; };
+    size_t S_=0, stride_=0, count_=0; vector<Chunk> chunks_;
+    void add_chunk(size_t cap){
+      Chunk c; c.cap=cap; c.mem.reset((uint8_t*)::operator new(cap*stride_, std::align_val_t(SLAB_ALIGN)));
+      chunks_.push_back(move(c));
+    }
+  public:
+    SymbolSlab()=default;
+    explicit SymbolSlab(size_t S):S_(S),stride_(max<size_t>(SLAB_ALIGN, (S+SLAB_ALIGN-1)/SLAB_ALIGN*SLAB_ALIGN)){}
+    size_t symbol_size() const { return S_; }
+    size_t stride() const { return stride_; }
+    size_t size() const { return count_; }
+    // garantisce n slot liberi contigui senza nuove allocazioni nei prossimi alloc()
+    void reserve(size_t n){ if(!n) return; if(chunks_.empty() || chunks_.back().cap-chunks_.back().used<n) add_chunk(n); }
+    // slot non inizializzato: il chiamante deve scrivere tutti gli S byte
+    uint8_t* alloc_raw(){
+      if(chunks_.empty() || chunks_.back().used==chunks_.back().cap) add_chunk(max<size_t>(16, chunks_.empty()? 16 : chunks_.back().cap*2));
+      Chunk& c=chunks_.back(); uint8_t* q=c.mem.get()+c.used*stride_; ++c.used; ++count_; return q;
+    }
+    // slot azzerato da S byte (la coda fino allo stride resta non inizializzata)
+    uint8_t* alloc(){ uint8_t* q=alloc_raw(); memset(q, 0, S_); return q; }
+    SymView add(const uint8_t* d, size_t len){ len=min(len, S_); uint8_t* q=alloc(); memcpy(q, d, len); return {q, (uint32_t)len}; }
+    SymView add(const vector<uint8_t>& v){ return add(v.data(), v.size()); }
+  };
+
+  // Allocatore allineato a SLAB_ALIGN per buffer di righe (OnlineDecoderT<SZ>): con S multiplo
+  // di 64 ogni riga parte su una cache line e i kernel a dimensione fissa non ricadono sul generico
+  template<typename T> struct AlignedAlloc{
+    using value_type=T; AlignedAlloc()=default; template<typename U> AlignedAlloc(const AlignedAlloc<U>&){}
+    T* allocate(size_t n){ return (T*)::operator new(n*sizeof(T), std::align_val_t(SLAB_ALIGN)); }
+    void deallocate(T* q, size_t){ ::operator delete(q, std::align_val_t(SLAB_ALIGN)); }
+    template<typename U> bool operator==(const AlignedAlloc<U>&) const { return true; }
+  };
+
+  struct Fp{ uint32_t seed, deg; SymView data; };
+
+  // Versioni del generatore negli 8 bit alti di Fp.deg: FP_GEN_* in src/fec/AuroraLtNeighbours.hpp
+  inline uint32_t fp_degree(const Fp& p){ return p.deg & FP_DEG_MASK; }
+  inline uint32_t fp_gen(const Fp& p){ return p.deg >> 24; }
+  inline uint32_t fp_pack_deg(uint32_t deg, uint32_t gen){ return (deg & FP_DEG_MASK) | (gen << 24); }
+  inline bool fp_known(const Fp& p){ return fp_gen(p)<=FP_GEN_SOURCE; }  // combinazione GF(2): le altre versioni sono scartate dai decoder LT
+  inline bool fp_is_source(const Fp& p){ return fp_gen(p)==FP_GEN_SOURCE; }
+
+  // Indici dei neighbour di un simbolo, come li ha mixati l'encoder: unico punto condiviso
+  // da Encoder::emit() e da tutti i decoder. mt19937 estrae con ripetizioni (le coppie si
+  // annullano), SplitMix estrae indici distinti con l'algoritmo di Floyd (fec::for_each_lt_neighbour,
+  // lo stesso della configurazione embedded).
+  // La bitmap per gli estratti oltre 32 e' per thread (emit_batch gira sul WorkerPool): cresce
+  // fino al massimo n visto, poi emit() e push() non allocano piu'.
+  inline uint64_t* lt_scratch(int n){
+    static thread_local vector<uint64_t> used; size_t w=lt_scratch_words((size_t)n); if(used.size()<w) used.resize(w); return used.data(); }
+  template<typename F> inline void for_each_neighbour(uint32_t seed, uint32_t deg, uint32_t gen, int n, F&& f){
+    if(gen==FP_GEN_SOURCE){ if(deg && seed<(uint32_t)n) f(seed); return; }
+    if(gen==FP_GEN_MT19937){ mt19937 g(seed); for(uint32_t i=0;i<deg;++i) f((uint32_t)(g()%n)); return; }
+    for_each_lt_neighbour(seed, deg, gen, (uint32_t)n, min(deg, (uint32_t)n)>32 ? lt_scratch(n) : nullptr, f);
+  }
+  template<typename F> inline void for_each_neighbour(const Fp& p, int n, F&& f){ for_each_neighbour(p.seed, fp_degree(p), fp_gen(p), n, f); }
   
-  // LT fallback "infinite-ish" fountain code implementation
+  // XOR di un simbolo su un altro: kernel SIMD scelto a runtime (src/fec/AuroraXorKernels.hpp).
+  // Encoder e decoder prendono invece una volta sola simd::xor_for(S): per S in
+  // simd::FIXED_SIZES e' il kernel srotolato a dimensione fissa.
+  inline void xor_bytes(uint8_t* dst, const uint8_t* src, size_t S){ simd::xor_into(dst, src, S); }
+
+  // Robust Soliton (Luby): rho ideale + spike tau in k/R, R = c*ln(k/delta)*sqrt(k).
+  // cdf[i] = P(grado <= i+1), campionata con ricerca binaria.
+  constexpr double SOLITON_C=0.1, SOLITON_DELTA=0.05;  // scelti con aurora_fec_bench degree
+  inline vector<double> robust_soliton_cdf(int k, double c=SOLITON_C, double delta=SOLITON_DELTA){
+    if(k<=1) return vector<double>(1, 1.0);
+    double R=max(1.0, c*log(k/delta)*sqrt((double)k)); int spike=max(1, min(k, (int)floor(k/R)));
+    vector<double> mu(k, 0.0);
+    for(int i=1;i<=k;++i){ double rho = i==1 ? 1.0/k : 1.0/((double)i*(i-1)); double tau = i<spike ? R/((double)i*k) : i==spike ? R*log(R/delta)/k : 0.0; mu[i-1]=rho+max(0.0,tau); }
+    double z=0; for(double& x:mu){ z+=x; x=z; } for(double& x:mu) x/=z; mu.back()=1.0;
+    return mu;
+  }
+  enum class DegreeDist{ LEGACY, ROBUST_SOLITON };
+  // Simboli da pre-generare per un pool che il mittente ruota: copre il peggior overhead
+  // misurato con Robust Soliton (aurora_fec_bench degree, 400 prove, K=4..1024) invece di K*3
+  inline int lt_pool_size(int K){ return K<=0 ? 0 : (int)ceil(1.25*K + 4.0*sqrt((double)K)) + 4; }
+
+  // MDS per K piccoli (segmenti critici da 1-4 simboli, dove l'overhead LT e' pessimo):
+  // Reed-Solomon sistematico con matrice di Cauchy su GF(256). Il repair con ESI e
+  // (K <= e < 256) vale sum_j src_j / (e ^ j); ogni sottomatrice quadrata di una Cauchy e'
+  // invertibile, quindi K simboli distinti qualsiasi ricostruiscono il segmento.
+  constexpr int MDS_MAX_K=32; constexpr uint32_t MDS_MAX_ESI=256;
+  inline bool mds_fits(int K){ return K>0 && K<=MDS_MAX_K; }
+  inline uint8_t mds_coef(uint32_t esi, uint32_t j){ return gf256().inv((uint8_t)(esi^j)); }
+  // ESI dell'r-esimo repair: dopo 256-K repair distinti si ricomincia (duplicati non innovativi)
+  inline uint32_t mds_repair_esi(int K, uint32_t r){ return (uint32_t)K+r%(MDS_MAX_ESI-(uint32_t)K); }
+
+  // Feedback del ricevitore su un canale di ritorno (opzionale): bitmap dei sorgenti ancora
+  // indeterminati di un segmento/blocco. Un Encoder con hint sceglie il seed di ogni repair LT
+  // tra HINT_CANDIDATES candidati: prima quelli con un solo neighbour indeterminato (il peeling
+  // lo risolve subito), poi quelli che ne toccano almeno uno. Il generatore dei neighbour non
+  // cambia: i decoder non sanno nulla del feedback.
+  // Sul filo: [n u16 LE][formato u8][bitmap (n+7)/8 byte | indici u16 LE], il piu' corto dei due.
+  constexpr int HINT_CANDIDATES=16;
+  struct Hint{
+    int n=0, n_missing=0; vector<uint64_t> missing;   // bit i = sorgente i non ancora determinato
+    static Hint missing_of(int n, const vector<uint64_t>& known){
+      Hint h; h.n=n; h.missing.assign(((size_t)n+63)/64, 0);
+      for(int i=0;i<n;++i) if(!(i>>6<(int)known.size() && known[i>>6]>>(i&63)&1)){ h.missing[i>>6]|=1ull<<(i&63); ++h.n_missing; }
+      return h;
+    }
+    bool has(int i) const { return i>=0 && i<n && missing[i>>6]>>(i&63)&1; }
+    bool empty() const { return n_missing==0; }
+    vector<uint8_t> pack() const {
+      vector<uint8_t> v{(uint8_t)n, (uint8_t)(n>>8), 0}; const size_t bm=((size_t)n+7)/8;
+      if((size_t)n_missing*2<bm){ v[2]=1; for(int i=0;i<n;++i) if(has(i)){ v.push_back((uint8_t)i); v.push_back((uint8_t)(i>>8)); } }
+      else for(size_t b=0;b<bm;++b) v.push_back((uint8_t)(missing[b>>3]>>(8*(b&7))));
+      return v;
+    }
+    // false se il buffer e' troncato o il formato sconosciuto
+    static bool unpack(const uint8_t* d, size_t len, Hint& h){
+      if(len<3 || d[2]>1) return false;
+      h=Hint{}; h.n=d[0]|d[1]<<8; h.missing.assign(((size_t)h.n+63)/64, 0);
+      auto mark=[&](int i){ if(i<h.n && !h.has(i)){ h.missing[i>>6]|=1ull<<(i&63); ++h.n_missing; } };
+      if(d[2]==1){ if((len-3)&1) return false; for(size_t o=3;o<len;o+=2) mark(d[o]|d[o+1]<<8); return true; }
+      if(len-3!=((size_t)h.n+7)/8) return false;
+      for(int i=0;i<h.n;++i) if(d[3+(i>>3)]>>(i&7)&1) mark(i);
+      return true;
+    }
+  };
+
+  // LT fallback "infinite-ish" fountain code implementation.
+  // systematic=true: i primi N() simboli emessi sono i blocchi sorgente, poi i simboli di repair.
+  // mds=true (se mds_fits(N())): sorgenti in chiaro, poi repair MDS invece che LT.
+  // Sorgenti e simboli emessi stanno nella stessa slab: gli Fp emessi sono viste valide finche'
+  // vive l'encoder, oppure chi ha preso la slab con take_slab().
+  // hint (se n == N()): i repair LT successivi coprono i sorgenti che il ricevitore non ha ancora.
   struct Encoder{
-    vector<vector<uint8_t>> sym; size_t S;
-    Encoder(const vector<uint8_t>& bytes, size_t s=256):S(s){ size_t n=(bytes.size()+S-1)/S; sym.assign(n, vector<uint8_t>(S,0)); for(size_t i=0;i<bytes.size(); ++i) sym[i/S][i%S]=bytes[i]; }
-    int N() const { return (int)sym.size(); }
+    size_t S; SymbolSlab slab; const uint8_t* src=nullptr; size_t stride=0; int n_src=0;
+    uint32_t gen=FP_GEN_SPLITMIX;  // FP_GEN_MT19937 per peer vecchi
+    DegreeDist dist=DegreeDist::ROBUST_SOLITON; vector<double> cdf; Hint hint;
+    bool systematic=false, mds=false; uint32_t next_src=0;   // next_src: prossimo ESI (sorgenti e repair MDS)
+    simd::XorFn xr;   // XOR su S byte (simd::xor_for)
+    Encoder(const uint8_t* bytes, size_t len, size_t s=256):S(s),slab(s),xr(simd::xor_for(s)){
+      n_src=(int)((len+S-1)/S); slab.reserve(n_src); stride=slab.stride();   // sorgenti in un solo chunk
+      for(int i=0;i<n_src;++i){ size_t off=(size_t)i*S; uint8_t* d=slab.alloc(); memcpy(d, bytes+off, min(S, len-off)); if(!i) src=d; }
+      cdf=robust_soliton_cdf(N());
+    }
+    Encoder(const vector<uint8_t>& bytes, size_t s=256):Encoder(bytes.data(), bytes.size(), s){}
+    int N() const { return n_src; }
+    const uint8_t* source(int i) const { return src+(size_t)i*stride; }
+    SymView source_view(int i) const { return {source(i), (uint32_t)S}; }
+    // spazio per altri n simboli emessi in un solo chunk (pool pre-generato)
+    void reserve(size_t n){ slab.reserve(n); }
+    // cede i byte di tutti i simboli emessi (e dei sorgenti): l'encoder non va piu' usato
+    SymbolSlab take_slab(){ n_src=0; src=nullptr; return move(slab); }
+    void set_robust_soliton(double c, double delta){ dist=DegreeDist::ROBUST_SOLITON; cdf=robust_soliton_cdf(N(), c, delta); }
+    // distribuzione storica (P(1)=1/2): tenuta per confronto nel bench
     static int deg(int n){ double u=util::rng.uni(); int k=1; while(k<n && u>(1.0-1.0/(k+1))) ++k; return max(1,min(n,k)); }
-    Fp emit(){ int n=N(); uint32_t seed=(uint32_t)util::rng.next(); mt19937 g(seed); int k=deg(n); vector<uint8_t> mix(S,0); for(int i=0;i<k;++i){ int id=g()%n; for(size_t b=0;b<S;++b) mix[b]^=sym[id][b]; } return {seed,(uint32_t)k,move(mix)}; }
+    int draw_deg(){ int n=N(); if(dist==DegreeDist::LEGACY) return deg(n);
+      int k=(int)(lower_bound(cdf.begin(), cdf.end(), util::rng.uni())-cdf.begin())+1; return max(1,min(n,k)); }
+    bool use_mds() const { return mds && mds_fits(N()); }
+    // seed del repair di grado k: quello estratto se non c'e' hint, altrimenti il miglior candidato
+    uint32_t steer(uint32_t seed, int k){
+      if(hint.empty() || hint.n!=N()) return seed;
+      uint32_t best=seed; int best_score=-1;
+      for(int c=0;c<HINT_CANDIDATES;++c){
+        if(c) seed=(uint32_t)util::rng.next();
+        int hits=0; for_each_neighbour(seed, (uint32_t)k, gen, N(), [&](uint32_t id){ hits+=hint.has((int)id); });
+        int score=hits==1? 2 : hits>1? 1 : 0;
+        if(score>best_score){ best=seed; best_score=score; if(score==2) break; }
+      }
+      return best;
+    }
+    bool sources_first() const { return systematic || use_mds(); }
+    Fp emit(){ int n=N();
+      if(sources_first() && next_src<(uint32_t)n){ uint32_t i=next_src++; return {i, fp_pack_deg(1, FP_GEN_SOURCE), source_view((int)i)}; }
+      if(use_mds()){ uint32_t esi=mds_repair_esi(n, next_src++-(uint32_t)n); uint8_t* d=slab.alloc_raw(); mds_mix(esi, d);
+        return {esi, fp_pack_deg((uint32_t)n, FP_GEN_MDS), SymView{d, (uint32_t)S}}; }
+      uint32_t seed=(uint32_t)util::rng.next(); int k=draw_deg(); seed=steer(seed, k); uint8_t* mix=slab.alloc();
+      for_each_neighbour(seed, (uint32_t)k, gen, n, [&](uint32_t id){ xr(mix, source((int)id), S); });
+      return {seed, fp_pack_deg((uint32_t)k, gen), SymView{mix, (uint32_t)S}}; }
+    // Batch: n simboli in out[0..n) come n chiamate a emit() (stessa sequenza rng), ma i
+    // repair sono solo pianificati in serie e mixati dopo, in parallelo (vedi emit_batches)
+    struct MixJob{ uint32_t seed, k; uint8_t* dst; };
+    vector<MixJob> jobs;   // scratch riusato tra i batch
+    void emit_batch(size_t n, Fp* out);
+    size_t plan_batch(size_t n, Fp* out){ int nn=N(); jobs.clear();
+      size_t srcs=sources_first() && next_src<(uint32_t)nn? (size_t)nn-next_src : 0; slab.reserve(n-min(n, srcs));
+      for(size_t i=0;i<n;++i){
+        if(sources_first() && next_src<(uint32_t)nn){ uint32_t s=next_src++; out[i]={s, fp_pack_deg(1, FP_GEN_SOURCE), source_view((int)s)}; continue; }
+        if(use_mds()){ uint32_t esi=mds_repair_esi(nn, next_src++-(uint32_t)nn); uint8_t* d=slab.alloc_raw();
+          jobs.push_back({esi, 0, d}); out[i]={esi, fp_pack_deg((uint32_t)nn, FP_GEN_MDS), SymView{d, (uint32_t)S}}; continue; }
+        uint32_t seed=(uint32_t)util::rng.next(); int k=draw_deg(); seed=steer(seed, k); uint8_t* mix=slab.alloc_raw();
+        jobs.push_back({seed, (uint32_t)k, mix}); out[i]={seed, fp_pack_deg((uint32_t)k, gen), SymView{mix, (uint32_t)S}};
+      }
+      return jobs.size(); }
+    // repair MDS ESI esi in dst (slot non azzerato)
+    void mds_mix(uint32_t esi, uint8_t* dst) const { const Gf256& g=gf256();
+      g.mul_into(dst, source(0), mds_coef(esi, 0), S); for(int j=1;j<N();++j) g.mul_add(dst, source(j), mds_coef(esi, (uint32_t)j), S); }
+    // primo neighbour copiato (slot non azzerato), gli altri in XOR
+    void mix(const MixJob& j) const { if(use_mds()){ mds_mix(j.seed, j.dst); return; } bool first=true;
+      for_each_neighbour(j.seed, j.k, gen, N(), [&](uint32_t id){ if(first){ memcpy(j.dst, source((int)id), S); first=false; } else xr(j.dst, source((int)id), S); }); }
+  };
+
+  // Piu' batch (es. segmenti critical e bulk dello stesso spawn) mixati in un solo
+  // parallel_for sul pool condiviso; sotto EMIT_PAR_MIN_BYTES tutto sul chiamante.
+  struct EmitBatch{ Encoder* enc; size_t n; Fp* out; };
+  constexpr size_t EMIT_PAR_MIN_BYTES=1<<18, EMIT_CHUNK=64;   // simboli per unita' di lavoro
+  inline void emit_batches(const EmitBatch* batches, size_t count, WorkerPool& pool=WorkerPool::shared()){
+    struct Range{ const Encoder* e; size_t b, end; }; vector<Range> rs; size_t work=0;
+    for(size_t bi=0;bi<count;++bi){ const EmitBatch& b=batches[bi]; size_t nj=b.enc->plan_batch(b.n, b.out); work+=nj*b.enc->S;
+      for(size_t i=0;i<nj;i+=EMIT_CHUNK) rs.push_back({b.enc, i, min(nj, i+EMIT_CHUNK)}); }
+    auto run=[&](size_t r){ const Range& x=rs[r]; for(size_t i=x.b;i<x.end;++i) x.e->mix(x.e->jobs[i]); };
+    if(work<EMIT_PAR_MIN_BYTES){ for(size_t r=0;r<rs.size();++r) run(r); return; }
+    pool.parallel_for(rs.size(), run);
+  }
+  inline void emit_batches(std::initializer_list<EmitBatch> batches, WorkerPool& pool=WorkerPool::shared()){ emit_batches(batches.begin(), batches.size(), pool); }
+  inline void Encoder::emit_batch(size_t n, Fp* out){ emit_batches({{this, n, out}}); }
+  // Esito di una decodifica anche incompleta: i sorgenti determinati dallo spazio delle righe
+  // ricevute. bytes n*S (slot non noti a zero), known bitmap a parole da 64 bit (bit i = sorgente i)
+  struct PartialSolve{
+    int n=0, n_known=0; vector<uint8_t> bytes; vector<uint64_t> known;
+    PartialSolve()=default;
+    PartialSolve(int n,size_t S):n(n),bytes((size_t)n*S, 0),known(((size_t)n+63)/64, 0){}
+    static PartialSolve full(int n, vector<uint8_t> b){ PartialSolve ps; ps.n=ps.n_known=n; ps.bytes=move(b); ps.known.assign(((size_t)n+63)/64, ~0ull); if(n&63) ps.known.back()=(1ull<<(n&63))-1; return ps; }
+    bool has(int i) const { return known[i>>6]>>(i&63)&1; }
+    void set(int i){ if(!has(i)){ known[i>>6]|=1ull<<(i&63); ++n_known; } }
+    bool complete() const { return n_known==n; }
+    int prefix() const { int i=0; while(i<n && has(i)) ++i; return i; }   // sorgenti noti consecutivi da 0
+    Hint hint() const { return Hint::missing_of(n, known); }   // feedback per l'encoder
   };
+
+  // Decoder GF(2) bit-packed: ogni riga dei coefficienti e' un bitset di parole da 64 bit
+  // (A in un unico buffer, stride W), l'eliminazione lavora in place con XOR a parola intera
+  // e non copia mai il sistema. Righe/rhs restano ridotte: push() successivi sono validi.
   struct Decoder{
-    int n; size_t S; vector<vector<uint8_t>> A, rhs;
-    Decoder(int n,size_t S):n(n),S(S){} 
-    void push(const Fp& p){ mt19937 g(p.seed); vector<int> idx(p.deg); for(uint32_t i=0;i<p.deg;++i) idx[i]=g()%n; vector<uint8_t> row(n,0); for(int id:idx) row[id]^=1; A.push_back(move(row)); rhs.push_back(p.data); }
-    pair<bool, vector<uint8_t>> solve(){ int m=A.size(); if(!m) return {false,{}}; vector<vector<uint8_t>> M=A; int r=0; vector<int> piv; vector<vector<uint8_t>> R=rhs;
-      for(int c=0;c<n && r<m;++c){ int s=-1; for(int i=r;i<m;++i) if(M[i][c]){ s=i; break; } if(s==-1) continue; swap(M[r],M[s]); swap(R[r],R[s]);
-        for(int i=0;i<m;++i) if(i!=r && M[i][c]){ for(int j=c;j<n;++j) M[i][j]^=M[r][j]; for(size_t b=0;b<S;++b) R[i][b]^=R[r][b]; } piv.push_back(c); r++; }
-      if((int)piv.size()<n) return {false,{}}; vector<vector<uint8_t>> sym(n, vector<uint8_t>(S,0));
-      for(int pi=(int)piv.size()-1; pi>=0; --pi){ int c=piv[pi], rr=pi; for(int j=c+1;j<n;++j) if(M[rr][j]) for(size_t b=0;b<S;++b) R[rr][b]^=sym[j][b]; sym[c]=R[rr]; }
-      vector<uint8_t> out; out.reserve(n*S); for(int i=0;i<n;++i) out.insert(out.end(), sym[i].begin(), sym[i].end()); return {true,out};
+    int n; size_t S, W; int m=0; vector<uint64_t> A; vector<uint8_t> rhs;
+    vector<int> src_row; int n_src=0; bool reduced=false;   // riga del sorgente i (modo sistematico), -1 se assente
+    vector<int> piv;   // dopo eliminate(): colonna pivot della riga i
+    simd::XorFn xr;
+    Decoder(int n,size_t S):n(n),S(S),W(((size_t)n+63)/64),src_row(n,-1),xr(simd::xor_for(S)){}
+    uint64_t* row(int i){ return A.data()+(size_t)i*W; }
+    uint8_t* data(int i){ return rhs.data()+(size_t)i*S; }
+    void push(const Fp& p){
+      if(!fp_known(p)) return;
+      if(fp_is_source(p) && p.seed<(uint32_t)n && src_row[p.seed]<0){ src_row[p.seed]=m; ++n_src; }
+      A.resize(A.size()+W, 0); rhs.resize(rhs.size()+S, 0); uint64_t* r=row(m);
+      for_each_neighbour(p, n, [&](uint32_t id){ r[id>>6]^=1ull<<(id&63); });
+      memcpy(data(m), p.data.data(), min(S, p.data.size())); ++m;
+    }
+    // riga gia' espressa come bitset (nw parole) + simbolo: usata dal core inattivo del peeling
+    void push_row(const uint64_t* bits, size_t nw, const uint8_t* d){
+      A.resize(A.size()+W, 0); rhs.resize(rhs.size()+S, 0);
+      copy(bits, bits+min(nw,W), row(m)); memcpy(data(m), d, S); ++m;
+    }
+    pair<bool, vector<uint8_t>> solve(){
+      if(!m || m<n) return {false,{}};   // rango n impossibile con meno di n righe
+      if(n_src==n && !reduced){   // tutti i sorgenti arrivati: nessuna eliminazione, solo copia
+        vector<uint8_t> out((size_t)n*S); for(int i=0;i<n;++i) memcpy(out.data()+(size_t)i*S, data(src_row[i]), S);
+        return {true, out};
+      }
+      if(eliminate()<n) return {false,{}};
+      // rango pieno: Gauss-Jordan completo, la riga i ha solo il bit i -> rhs[i] e' il simbolo i
+      return {true, vector<uint8_t>(rhs.begin(), rhs.begin()+(size_t)n*S)};
+    }
+    // Senza rango pieno il sistema eliminato e' comunque in RREF: il sorgente c e' determinato
+    // solo se la riga con pivot c non ha altri bit (colonne mancanti)
+    PartialSolve partial(){
+      PartialSolve ps(n, S); if(!m) return ps;
+      const int r=eliminate();
+      for(int i=0;i<r;++i){ const uint64_t* ri=row(i); int bits=0; for(size_t w=0;w<W && bits<2;++w) bits+=popcount(ri[w]);
+        if(bits==1){ memcpy(ps.bytes.data()+(size_t)piv[i]*S, data(i), S); ps.set(piv[i]); } }
+      return ps;
+    }
+    // Gauss-Jordan in place, ritorna il rango. I sorgenti presenti fanno da pivot gia' pronti:
+    // l'eliminazione li sottrae dai repair e il lavoro vero resta solo sulle colonne mancanti
+    int eliminate(){
+      reduced=true; piv.clear(); int r=0;
+      for(int c=0;c<n && r<m;++c){
+        size_t w=(size_t)c>>6; uint64_t bit=1ull<<(c&63);
+        int s=-1; for(int i=r;i<m;++i) if(row(i)[w]&bit){ s=i; break; }
+        if(s==-1) continue;
+        // righe >= r sono nulle sulle colonne < c: basta scambiare dalla parola w in poi
+        if(s!=r){ swap_ranges(row(s)+w, row(s)+W, row(r)+w); swap_ranges(data(s), data(s)+S, data(r)); }
+        const uint64_t* pr=row(r); const uint8_t* pd=data(r);
+        for(int i=0;i<m;++i){ if(i==r) continue; uint64_t* ri=row(i); if(!(ri[w]&bit)) continue;
+          for(size_t j=w;j<W;++j) ri[j]^=pr[j];
+          xr(data(i), pd, S); }
+        piv.push_back(c); ++r;
+      }
+      return r;
+    }
+  };
+
+  // Neighbour set di un simbolo LT: stessa sequenza di Encoder::emit(),
+  // gli indici ripetuti si annullano in GF(2)
+  inline vector<uint32_t> lt_neighbours(const Fp& p, int n){
+    vector<uint32_t> idx; idx.reserve(fp_degree(p)); for_each_neighbour(p, n, [&](uint32_t id){ idx.push_back(id); });
+    sort(idx.begin(), idx.end()); vector<uint32_t> out; out.reserve(idx.size());
+    for(size_t i=0;i<idx.size();){ size_t j=i; while(j<idx.size() && idx[j]==idx[i]) ++j; if((j-i)&1) out.push_back(idx[i]); i=j; }
+    return out;
+  }
+
+  // Decoder sparso per simboli LT: peeling (belief propagation) e, quando si blocca,
+  // inattivazione di poche colonne che finiscono in un piccolo core denso risolto con Decoder.
+  // La fase strutturale lavora solo sugli indici e registra le XOR da fare; i dati
+  // vengono toccati solo se il sistema e' risolvibile. Costo ~lineare in K per LT.
+  struct PeelingDecoder{
+    int n; size_t S; int m=0;
+    vector<vector<uint32_t>> cols; vector<uint8_t> rhs; vector<int> src_row; int n_src=0; simd::XorFn xr;
+    PeelingDecoder(int n,size_t S):n(n),S(S),src_row(n,-1),xr(simd::xor_for(S)){}
+    // Il rango non e' noto prima di decode(): vengono scartati (false) solo i simboli di cui la
+    // dipendenza e' certa, cioe' sorgenti gia' ricevuti e repair sui soli sorgenti ricevuti
+    bool push(const Fp& p){
+      if(!fp_known(p)) return false;
+      const bool src=fp_is_source(p) && p.seed<(uint32_t)n;
+      if(src && src_row[p.seed]>=0) return false;
+      vector<uint32_t> c=lt_neighbours(p, n);
+      if(!src && all_of(c.begin(), c.end(), [&](uint32_t id){ return src_row[id]>=0; })) return false;
+      if(src){ src_row[p.seed]=m; ++n_src; }
+      cols.push_back(move(c)); rhs.resize(rhs.size()+S, 0);
+      memcpy(rhs.data()+(size_t)m*S, p.data.data(), min(S, p.data.size())); ++m; return true;
+    }
+    void push_row(vector<uint32_t> c, const uint8_t* d){
+      cols.push_back(move(c)); rhs.resize(rhs.size()+S, 0); memcpy(rhs.data()+(size_t)m*S, d, S); ++m;
+    }
+    pair<bool, vector<uint8_t>> solve(){
+      if(!m || m<n) return {false,{}};
+      PartialSolve ps=decode(true); if(!ps.complete()) return {false,{}};
+      return {true, move(ps.bytes)};
+    }
+    // Anche senza rango pieno: colonne risolte dal peeling (o inattive) il cui valore dipende
+    // solo da inattive determinate dal core. Sottoinsieme esatto dei sorgenti noti, salvo le
+    // combinazioni di inattive determinate come somma ma non singolarmente.
+    PartialSolve partial(){ return decode(false); }
+    // all_or_nothing: si ferma (esito vuoto) appena il rango pieno e' escluso
+    PartialSolve decode(bool all_or_nothing){
+      PartialSolve ps(n, S); if(!m) return ps;
+      if(n_src==n){ for(int i=0;i<n;++i){ memcpy(ps.bytes.data()+(size_t)i*S, rhs.data()+(size_t)src_row[i]*S, S); ps.set(i); } return ps; }
+      enum : uint8_t { ACTIVE, RESOLVED, INACTIVE };
+      vector<uint8_t> st(n, ACTIVE); vector<int> pivot(n, -1), inact_idx(n, -1);
+      vector<int> deg(m); vector<uint8_t> used(m, 0); vector<vector<uint64_t>> mask(m);
+      vector<vector<int>> rows_of(n);
+      for(int r=0;r<m;++r){ deg[r]=(int)cols[r].size(); for(uint32_t c:cols[r]) rows_of[c].push_back(r); }
+      vector<pair<int,int>> ops;  // (dst, src): rhs[dst] ^= rhs[src]
+      vector<int> q; for(int r=0;r<m;++r) if(deg[r]==1) q.push_back(r);
+      int left=n, n_inact=0;
+      auto mask_set=[&](int r, int b){ auto& v=mask[r]; if(v.size()<=(size_t)(b>>6)) v.resize((b>>6)+1, 0); v[b>>6]|=1ull<<(b&63); };
+      auto mask_xor=[&](int dst, int src){ auto& d=mask[dst]; const auto& s2=mask[src]; if(d.size()<s2.size()) d.resize(s2.size(), 0); for(size_t i=0;i<s2.size();++i) d[i]^=s2[i]; };
+      while(left>0){
+        if(q.empty()){
+          // peeling bloccato: inattiva tutte le colonne attive tranne una della riga di grado minimo
+          int best=-1; for(int r=0;r<m;++r) if(!used[r] && deg[r]>=2 && (best<0 || deg[r]<deg[best])) best=r;
+          if(best<0){ if(all_or_nothing) return ps; break; }   // le righe rimaste non toccano colonne attive
+          bool keep=true;
+          for(uint32_t c:cols[best]){ if(st[c]!=ACTIVE) continue; if(keep){ keep=false; continue; }
+            st[c]=INACTIVE; inact_idx[c]=n_inact++; --left;
+            for(int r:rows_of[c]) if(!used[r]){ mask_set(r, inact_idx[c]); if(--deg[r]==1) q.push_back(r); } }
+          continue;
+        }
+        int r=q.back(); q.pop_back(); if(used[r] || deg[r]!=1) continue;
+        int c=-1; for(uint32_t x:cols[r]) if(st[x]==ACTIVE){ c=(int)x; break; }
+        used[r]=1; st[c]=RESOLVED; pivot[c]=r; --left;
+        for(int r2:rows_of[c]){ if(r2==r || used[r2]) continue; ops.push_back({r2, r}); mask_xor(r2, r); if(--deg[r2]==1) q.push_back(r2); }
+      }
+      // dati: replay delle XOR registrate su una copia degli rhs
+      vector<uint8_t> R=rhs;
+      for(auto& o:ops) xr(R.data()+(size_t)o.first*S, R.data()+(size_t)o.second*S, S);
+      PartialSolve xi;
+      if(n_inact>0){
+        Decoder core(n_inact, S); size_t nw=((size_t)n_inact+63)/64; vector<uint64_t> zero(nw, 0);
+        for(int r=0;r<m;++r) if(!used[r]){ const auto& v=mask[r]; core.push_row(v.empty()? zero.data() : v.data(), v.size(), R.data()+(size_t)r*S); }
+        if(all_or_nothing){ auto [ok, xs]=core.solve(); if(!ok) return ps; xi=PartialSolve::full(n_inact, move(xs)); }
+        else xi=core.partial();
+      }
+      for(int c=0;c<n;++c){
+        uint8_t* dst=ps.bytes.data()+(size_t)c*S;
+        if(st[c]==ACTIVE) continue;
+        if(st[c]==INACTIVE){ if(xi.has(inact_idx[c])){ memcpy(dst, xi.bytes.data()+(size_t)inact_idx[c]*S, S); ps.set(c); } continue; }
+        int r=pivot[c]; const auto& v=mask[r]; bool ok=true;
+        for(size_t w=0;w<v.size() && ok;++w) ok=(v[w]&~xi.known[w])==0;
+        if(!ok) continue;
+        memcpy(dst, R.data()+(size_t)r*S, S);
+        for(size_t w=0;w<v.size();++w) for(uint64_t b=v[w]; b; b&=b-1){ int qi=(int)(w*64+countr_zero(b)); xr(dst, xi.bytes.data()+(size_t)qi*S, S); }
+        ps.set(c);
+      }
+      return ps;
+    }
+  };
+
+  // Decoder online: elimina ogni simbolo appena arriva contro le righe pivot gia' presenti
+  // (slot c = riga con bit di testa c, forma a scala). Memoria fissa n x (W + S), i simboli
+  // non innovativi vengono scartati subito, rank() dice quando solve() puo' riuscire.
+  // Il lavoro per step scala con i simboli nuovi, non con quelli gia' ricevuti.
+  // SZ > 0 (multiplo di 64): dimensione simbolo fissata a compile time, riga di lavoro in un
+  // array e XOR con simd::xor_fixed<SZ> srotolato; SZ = 0: S a runtime (OnlineDecoder).
+  template<size_t SZ=0> struct OnlineDecoderT{
+    int n; size_t S, W; int rank_=0, units=0; bool solved=false;   // units: righe pivot = sorgente puro
+    vector<uint64_t> A; conditional_t<SZ!=0, vector<uint8_t, AlignedAlloc<uint8_t>>, vector<uint8_t>> rhs; vector<uint8_t> has;
+    vector<uint64_t> tmp; alignas(SLAB_ALIGN) conditional_t<SZ!=0, array<uint8_t, SZ>, vector<uint8_t>> tmpd{};
+    simd::XorFn xr;
+    OnlineDecoderT(int n,size_t s=SZ):n(n),S(SZ? SZ : s),W(((size_t)n+63)/64),A((size_t)n*W,0),rhs((size_t)n*S,0),has(n,0),tmp(W),xr(simd::xor_for(S)){
+      if constexpr(SZ==0) tmpd.resize(S); }
+    size_t sz() const { return SZ? SZ : S; }
+    void xs(uint8_t* d, const uint8_t* q) const { if constexpr(SZ!=0) simd::xor_fixed<SZ>(d, q); else xr(d, q, S); }
+    int rank() const { return rank_; }
+    bool complete() const { return rank_==n; }
+    bool push(const Fp& p){
+      if(!fp_known(p)) return false;
+      // sorgente su colonna libera: la riga unitaria e' gia' ridotta, inserimento diretto
+      if(fp_is_source(p) && p.seed<(uint32_t)n && !has[p.seed] && !solved){
+        uint32_t c=p.seed; A[(size_t)c*W+(c>>6)]=1ull<<(c&63); uint8_t* dc=rhs.data()+(size_t)c*sz();
+        size_t len=min(sz(), p.data.size()); memcpy(dc, p.data.data(), len); fill(dc+len, dc+sz(), 0);
+        has[c]=1; ++rank_; ++units; return true;
+      }
+      fill(tmp.begin(), tmp.end(), 0); fill(tmpd.begin(), tmpd.end(), 0);
+      for_each_neighbour(p, n, [&](uint32_t id){ tmp[id>>6]^=1ull<<(id&63); });
+      memcpy(tmpd.data(), p.data.data(), min(sz(), p.data.size()));
+      return reduce_and_insert();
+    }
+    bool push_row(const uint64_t* bits, size_t nw, const uint8_t* d){
+      fill(tmp.begin(), tmp.end(), 0); copy(bits, bits+min(nw,W), tmp.begin()); memcpy(tmpd.data(), d, sz());
+      return reduce_and_insert();
+    }
+    // true se la riga entrante aumenta il rango
+    bool reduce_and_insert(){
+      if(solved) return false;
+      for(size_t w=0;w<W;++w){
+        while(tmp[w]){
+          int c=(int)(w*64+countr_zero(tmp[w]));
+          if(!has[c]){
+            copy(tmp.begin()+w, tmp.end(), A.begin()+(size_t)c*W+w); memcpy(rhs.data()+(size_t)c*sz(), tmpd.data(), sz());
+            has[c]=1; ++rank_; return true;
+          }
+          const uint64_t* pr=A.data()+(size_t)c*W;   // nessun bit sotto c nella riga pivot
+          for(size_t j=w;j<W;++j) tmp[j]^=pr[j];
+          xs(tmpd.data(), rhs.data()+(size_t)c*sz());
+        }
+      }
+      return false;
+    }
+    pair<bool, vector<uint8_t>> solve(){
+      if(!complete() || !n) return {false,{}};
+      if(!solved && units==n) solved=true;   // solo sorgenti: rhs e' gia' il payload
+      if(!solved){
+        // back-substitution dall'ultima colonna: le righe j>c sono gia' simboli sorgente
+        for(int c=n-1;c>=0;--c){
+          uint64_t* rc=A.data()+(size_t)c*W; uint8_t* dc=rhs.data()+(size_t)c*sz();
+          rc[c>>6]&=~(1ull<<(c&63));
+          for(size_t w=(size_t)c>>6;w<W;++w) for(uint64_t b=rc[w]; b; b&=b-1) xs(dc, rhs.data()+(w*64+countr_zero(b))*sz());
+          fill(rc, rc+W, 0); rc[c>>6]=1ull<<(c&63);
+        }
+        solved=true;
+      }
+      return {true, vector<uint8_t>(rhs.begin(), rhs.end())};
+    }
+    // Sorgenti determinati prima del rango pieno: back-substitution in place sulle sole colonne
+    // pivot (la forma a scala resta valida per i push successivi); la riga c da' il sorgente c
+    // quando non dipende piu' da colonne mancanti
+    PartialSolve partial(){
+      if(complete()) return PartialSolve::full(n, solve().second);
+      PartialSolve ps(n, sz()); vector<uint64_t> pm(W, 0);
+      for(int c=0;c<n;++c) if(has[c]) pm[c>>6]|=1ull<<(c&63);
+      for(int c=n-1;c>=0;--c){
+        if(!has[c]) continue;
+        uint64_t* rc=A.data()+(size_t)c*W; uint8_t* dc=rhs.data()+(size_t)c*sz(); const size_t wc=(size_t)c>>6; bool unit=true;
+        for(size_t w=wc;w<W;++w){
+          // le righe j>c sono gia' ridotte: la XOR non reintroduce bit pivot, solo colonne mancanti
+          for(uint64_t b=rc[w]&pm[w]&~(w==wc? 1ull<<(c&63) : 0); b; b&=b-1){
+            size_t j=w*64+countr_zero(b); const uint64_t* rj=A.data()+j*W;
+            for(size_t x=w;x<W;++x) rc[x]^=rj[x];
+            xs(dc, rhs.data()+j*sz());
+          }
+          unit&=rc[w]==(w==wc? 1ull<<(c&63) : 0);
+        }
+        if(unit){ memcpy(ps.bytes.data()+(size_t)c*sz(), dc, sz()); ps.set(c); }
+      }
+      return ps;
+    }
+  };
+
+  using OnlineDecoder=OnlineDecoderT<>;
+  // Dispatcher runtime -> compile time: f(integral_constant<size_t, S>) per S in
+  // simd::FIXED_SIZES, f(integral_constant<size_t, 0>) (percorso generico) altrimenti
+  template<typename F> inline decltype(auto) with_symbol_size(size_t S, F&& f){
+    switch(S){
+      case 64: return f(integral_constant<size_t, 64>{}); case 128: return f(integral_constant<size_t, 128>{});
+      case 256: return f(integral_constant<size_t, 256>{}); case 512: return f(integral_constant<size_t, 512>{});
+      case 1024: return f(integral_constant<size_t, 1024>{}); default: return f(integral_constant<size_t, 0>{});
+    }
+  }
+
+  // Decoder MDS: tiene i primi n simboli con ESI distinti, poi sottrae dai repair i sorgenti
+  // ricevuti e risolve in GF(256) il sistema di Cauchy m x m sulle sole colonne mancanti
+  struct MdsDecoder{
+    int n; size_t S; vector<uint8_t> rhs, seen; vector<uint32_t> esi; bool solved=false;
+    MdsDecoder(int n,size_t S):n(n),S(S),seen(n>0? MDS_MAX_ESI:0, 0){}
+    int rank() const { return (int)esi.size(); }
+    bool complete() const { return n>0 && (int)esi.size()==n; }
+    // false per duplicati, ESI fuori range, simboli LT o decoder gia' pieno
+    bool push(const Fp& p){
+      uint32_t e=p.seed; bool ok=fp_is_source(p)? e<(uint32_t)n : fp_gen(p)==FP_GEN_MDS && e>=(uint32_t)n && e<MDS_MAX_ESI;
+      if(!ok || complete() || seen[e]) return false;
+      seen[e]=1; esi.push_back(e); rhs.resize(rhs.size()+S, 0);
+      memcpy(rhs.data()+rhs.size()-S, p.data.data(), min(S, p.data.size())); return true;
+    }
+    pair<bool, vector<uint8_t>> solve(){
+      if(!complete()) return {false,{}};
+      if(solved) return {true, rhs};
+      const Gf256& g=gf256(); vector<uint8_t> out((size_t)n*S); vector<uint8_t> have(n, 0); vector<int> rep, miss;
+      for(int i=0;i<n;++i){ if(esi[i]<(uint32_t)n){ memcpy(out.data()+(size_t)esi[i]*S, rhs.data()+(size_t)i*S, S); have[esi[i]]=1; } else rep.push_back(i); }
+      for(int c=0;c<n;++c) if(!have[c]) miss.push_back(c);
+      const int m=(int)miss.size(); vector<uint8_t> M((size_t)m*m); auto row=[&](int r){ return rhs.data()+(size_t)rep[r]*S; };
+      for(int r=0;r<m;++r){ uint32_t e=esi[rep[r]];
+        for(int c=0;c<n;++c) if(have[c]) g.mul_add(row(r), out.data()+(size_t)c*S, mds_coef(e, (uint32_t)c), S);
+        for(int k=0;k<m;++k) M[(size_t)r*m+k]=mds_coef(e, (uint32_t)miss[k]); }
+      for(int k=0;k<m;++k){
+        int p=k; while(!M[(size_t)p*m+k]) ++p;   // esiste: la sottomatrice di Cauchy e' invertibile
+        if(p!=k){ swap_ranges(M.begin()+(size_t)p*m, M.begin()+(size_t)(p+1)*m, M.begin()+(size_t)k*m); swap(rep[p], rep[k]); }
+        uint8_t inv=g.inv(M[(size_t)k*m+k]); for(int c=k;c<m;++c) M[(size_t)k*m+c]=g.mul(M[(size_t)k*m+c], inv); g.scale(row(k), inv, S);
+        for(int r=0;r<m;++r){ uint8_t f=M[(size_t)r*m+k]; if(r==k || !f) continue;
+          for(int c=k;c<m;++c) M[(size_t)r*m+c]^=g.mul(f, M[(size_t)k*m+c]);
+          g.mul_add(row(r), row(k), f, S); }
+      }
+      for(int k=0;k<m;++k) memcpy(out.data()+(size_t)miss[k]*S, row(k), S);
+      rhs=move(out); solved=true; return {true, rhs};
+    }
+    // Con meno di n simboli nessuna colonna mancante e' determinata (ogni n righe sono
+    // indipendenti): noti solo i sorgenti ricevuti
+    PartialSolve partial(){
+      if(complete()) return PartialSolve::full(n, solve().second);
+      PartialSolve ps(n, S);
+      for(size_t i=0;i<esi.size();++i) if(esi[i]<(uint32_t)n){ memcpy(ps.bytes.data()+(size_t)esi[i]*S, rhs.data()+i*S, S); ps.set((int)esi[i]); }
+      return ps;
+    }
+  };
+
+  // Scelta del decoder: denso online (rango esatto), sparso (peeling + inattivazione) o MDS
+  enum class DecoderKind : uint8_t { DENSE, PEELING, MDS };
+  constexpr int PEELING_MIN_K = 128;  // sotto questa soglia il denso e' gia' piu' rapido (aurora_fec_bench peel)
+  inline DecoderKind pick_decoder(int K){ return K>=PEELING_MIN_K ? DecoderKind::PEELING : DecoderKind::DENSE; }
+  // Decoder persistente per segmento: push() incrementali, ready() dice quando vale la pena
+  // tentare solve(). Per il peeling il rango non e' noto: si ritenta solo dopo n/32 simboli nuovi.
+  struct AnyDecoder{
+    DecoderKind kind; OnlineDecoder dense; PeelingDecoder peel; MdsDecoder mds; int tried_m=0;
+    AnyDecoder(DecoderKind k,int n,size_t S):kind(k),dense(k==DecoderKind::DENSE? n:0,S),peel(k==DecoderKind::PEELING? n:0,S),mds(k==DecoderKind::MDS? n:0,S){}
+    // true se il simbolo e' stato tenuto: innovativo per denso e MDS, non dipendente in modo evidente per il peeling
+    bool push(const Fp& p){ if(kind==DecoderKind::DENSE) return dense.push(p); if(kind==DecoderKind::MDS) return mds.push(p); return peel.push(p); }
+    int rank() const { return kind==DecoderKind::DENSE? dense.rank() : kind==DecoderKind::MDS? mds.rank() : min(peel.m, peel.n); }
+    bool ready() const { return kind==DecoderKind::DENSE? dense.complete() : kind==DecoderKind::MDS? mds.complete() : (peel.m>=peel.n && peel.m>=tried_m+max(1, peel.n/32)); }
+    pair<bool, vector<uint8_t>> solve(){
+      if(kind==DecoderKind::DENSE) return dense.solve();
+      if(kind==DecoderKind::MDS) return mds.solve();
+      auto r=peel.solve(); if(!r.first) tried_m=peel.m; return r;
+    }
+    PartialSolve partial(){ return kind==DecoderKind::DENSE? dense.partial() : kind==DecoderKind::MDS? mds.partial() : peel.partial(); }
+  };
+
+  // Blocchi sorgente e sub-block (RFC 6330, 4.4.1.2): un payload da Kt simboli diventa Z blocchi
+  // indipendenti da al piu' BLOCK_MAX_K simboli (decodifica lineare nel payload, blocchi in
+  // parallelo) e ogni blocco N sub-block di sotto-simboli da multipli di SUB_ALIGN byte, cosi'
+  // che il sistema K x S' di un sub-block stia in SUBBLOCK_WS byte.
+  struct Partition{ uint32_t IL, IS, JL, JS; };   // I elementi in JL parti da IL e JS parti da IS
+  inline Partition partition(uint32_t I, uint32_t J){ uint32_t IL=(I+J-1)/J, IS=I/J, JL=I-IS*J; return {IL, IS, JL, J-JL}; }
+  constexpr uint32_t BLOCK_MAX_K=1024; constexpr size_t SUBBLOCK_WS=1<<20, SUB_ALIGN=8;
+  struct BlockLayout{
+    size_t size=0, S=0; uint32_t Kt=0, Z=1, N=1; Partition kp{}, sp{};
+    uint32_t K(uint32_t b) const { return b<kp.JL? kp.IL : kp.IS; }
+    size_t offset(uint32_t b) const { return (b<kp.JL? (size_t)b*kp.IL : (size_t)kp.JL*kp.IL+(size_t)(b-kp.JL)*kp.IS)*S; }
+    size_t bytes(uint32_t b) const { return min(size, offset(b)+(size_t)K(b)*S)-offset(b); }   // ultimo blocco senza padding
+    size_t sub_size(uint32_t j) const { return N==1? S : (size_t)(j<sp.JL? sp.IL : sp.IS)*SUB_ALIGN; }
+    size_t sub_offset(uint32_t j) const { return N==1? 0 : (j<sp.JL? (size_t)j*sp.IL : (size_t)sp.JL*sp.IL+(size_t)(j-sp.JL)*sp.IS)*SUB_ALIGN; }
+  };
+  inline BlockLayout block_layout(size_t size, size_t S, uint32_t kmax=BLOCK_MAX_K, size_t ws=SUBBLOCK_WS){
+    BlockLayout l; l.size=size; l.S=S; l.Kt=(uint32_t)((size+S-1)/S);
+    l.Z=max<uint32_t>(1, (l.Kt+kmax-1)/kmax); l.kp=partition(l.Kt, l.Z);
+    if(S%SUB_ALIGN==0){ uint32_t units=(uint32_t)(S/SUB_ALIGN);
+      while(l.N<units && (size_t)((units+l.N-1)/l.N)*SUB_ALIGN*l.kp.IL>ws) ++l.N;
+      l.sp=partition(units, l.N); }
+    return l;
+  }
+  // Decoder di un payload a blocchi: un AnyDecoder per (blocco, sub-block). I sub-block di un
+  // blocco condividono la struttura (stessi Fp, fette diverse dei byte) e si completano insieme.
+  // known ha un byte per simbolo del payload (1 = gia' in out), aggiornato da solve_ready()
+  // e, per i blocchi incompleti, da partial().
+  struct BlockedDecoder{
+    BlockLayout lay; vector<AnyDecoder> decs; vector<uint8_t> done, out, known, fresh; uint32_t n_done=0;
+    // mds=true: i blocchi con mds_fits(K) ricevono repair MDS (Encoder::mds) e usano MdsDecoder
+    explicit BlockedDecoder(const BlockLayout& l, bool mds=false):lay(l),done(l.Z, 0),out(l.size),known(l.Kt, 0),fresh(l.Z, 0){
+      decs.reserve((size_t)l.Z*l.N);
+      for(uint32_t b=0;b<l.Z;++b){ int K=(int)l.K(b); DecoderKind k=mds && mds_fits(K)? DecoderKind::MDS : pick_decoder(K);
+        for(uint32_t j=0;j<l.N;++j) decs.emplace_back(k, K, l.sub_size(j)); }
+    }
+    AnyDecoder& dec(uint32_t b, uint32_t j){ return decs[(size_t)b*lay.N+j]; }
+    const AnyDecoder& dec(uint32_t b, uint32_t j) const { return decs[(size_t)b*lay.N+j]; }
+    bool block_done(uint32_t b) const { return done[b]; }
+    bool complete() const { return n_done==lay.Z; }
+    // true se il simbolo e' innovativo per il suo blocco (vedi AnyDecoder::push); false anche per
+    // sbn fuori range, blocco gia' completo o generatore sconosciuto. I sub-block hanno gli stessi
+    // coefficienti: l'esito e' lo stesso per tutti.
+    bool push(uint32_t sbn, const Fp& p){ if(sbn>=lay.Z || done[sbn]) return false; bool kept=false;
+      for(uint32_t j=0;j<lay.N;++j){ size_t off=min(lay.sub_offset(j), (size_t)p.data.size());
+        Fp q{p.seed, p.deg, SymView{p.data.data()+off, (uint32_t)min(lay.sub_size(j), (size_t)p.data.size()-off)}}; kept|=dec(sbn, j).push(q); }
+      fresh[sbn]|=kept; return kept; }
+    bool ready(uint32_t b) const { if(done[b]) return false; for(uint32_t j=0;j<lay.N;++j) if(!dec(b, j).ready()) return false; return true; }
+    // Risolve in parallelo i blocchi pronti e li copia in out. on_block(sbn) e' chiamato dal
+    // worker appena il suo blocco e' in out (chiamate serializzate). Ritorna i blocchi completati.
+    uint32_t solve_ready(const function<void(uint32_t)>& on_block={}, WorkerPool& pool=WorkerPool::shared()){
+      vector<uint32_t> todo; for(uint32_t b=0;b<lay.Z;++b) if(ready(b)) todo.push_back(b);
+      std::mutex mu; std::atomic<uint32_t> got{0};
+      pool.parallel_for(todo.size(), [&](size_t t){
+        uint32_t b=todo[t]; vector<vector<uint8_t>> parts(lay.N);
+        for(uint32_t j=0;j<lay.N;++j){ auto r=dec(b, j).solve(); if(!r.first) return; parts[j]=move(r.second); }
+        for(uint32_t i=0;i<lay.K(b);++i) for(uint32_t j=0;j<lay.N;++j) put(b, i, j, parts[j].data()+(size_t)i*lay.sub_size(j));
+        for(uint32_t j=0;j<lay.N;++j) dec(b, j)=AnyDecoder(DecoderKind::DENSE, 0, 0);   // sistema non piu' necessario
+        fill_n(known.begin()+lay.offset(b)/lay.S, lay.K(b), 1); done[b]=1; ++got;
+        if(on_block){ std::lock_guard<std::mutex> lk(mu); on_block(b); }
+      });
+      n_done+=got; return got;
+    }
+    // Recupero parziale dei blocchi incompleti che hanno ricevuto simboli dall'ultima chiamata:
+    // un simbolo e' noto quando lo e' in tutti i suoi sub-block e finisce subito in out.
+    // Ritorna i byte del payload ricostruiti finora.
+    size_t partial(WorkerPool& pool=WorkerPool::shared()){
+      vector<uint32_t> todo; for(uint32_t b=0;b<lay.Z;++b) if(!done[b] && fresh[b]){ todo.push_back(b); fresh[b]=0; }
+      pool.parallel_for(todo.size(), [&](size_t t){
+        uint32_t b=todo[t]; vector<PartialSolve> parts; parts.reserve(lay.N);
+        for(uint32_t j=0;j<lay.N;++j) parts.push_back(dec(b, j).partial());
+        uint8_t* kb=known.data()+lay.offset(b)/lay.S;   // i blocchi non condividono byte di known
+        for(uint32_t i=0;i<lay.K(b);++i){
+          if(kb[i]) continue;
+          bool all=true; for(uint32_t j=0;j<lay.N && all;++j) all=parts[j].has((int)i);
+          if(!all) continue;
+          for(uint32_t j=0;j<lay.N;++j) put(b, i, j, parts[j].bytes.data()+(size_t)i*lay.sub_size(j));
+          kb[i]=1;
+        }
+      });
+      return known_bytes();
+    }
+    // Feedback del blocco b dai byte di known (aggiornati da solve_ready()/partial())
+    Hint hint(uint32_t b) const { Hint h; h.n=(int)lay.K(b); h.missing.assign(((size_t)h.n+63)/64, 0);
+      const uint8_t* kb=known.data()+lay.offset(b)/lay.S; for(int i=0;i<h.n;++i) if(!kb[i]){ h.missing[i>>6]|=1ull<<(i&63); ++h.n_missing; }
+      return h; }
+    size_t known_bytes() const { size_t t=0; for(uint32_t i=0;i<lay.Kt;++i) if(known[i]) t+=min(lay.S, lay.size-(size_t)i*lay.S); return t; }
+    // byte ricostruiti consecutivi dall'inizio del payload
+    size_t prefix_bytes() const { uint32_t i=0; while(i<lay.Kt && known[i]) ++i; return min(lay.size, (size_t)i*lay.S); }
+    // sotto-simbolo j del simbolo i del blocco b in out (l'ultimo blocco senza padding)
+    void put(uint32_t b, uint32_t i, uint32_t j, const uint8_t* sub){
+      size_t o=(size_t)i*lay.S+lay.sub_offset(j), nb=lay.bytes(b);
+      if(o<nb) memcpy(out.data()+lay.offset(b)+o, sub, min(lay.sub_size(j), nb-o));
+    }
+  };
+
+  // Costo di decodifica stimato (ms) di un blocco K x S: denso ~ a*K^3/64 (parole di
+  // eliminazione) + b*K^2*S (XOR dei simboli), peeling ~ c*K*S. I coefficienti vengono dal
+  // microbenchmark di calibrate() (LT non sistematico, caso peggiore), una volta per processo.
+  struct DecodeCost{
+    double a=0, b=0, c=0;
+    double block_ms(uint32_t K, size_t S) const { double k=K; return pick_decoder((int)K)==DecoderKind::PEELING? c*k*(double)S : a*k*k*k/64+b*k*k*(double)S; }
+    double payload_ms(size_t size, size_t S) const {
+      if(!size || !S) return 0;
+      BlockLayout l=block_layout(size, S); double t=0; for(uint32_t b=0;b<l.Z;++b) t+=block_ms(l.K(b), S); return t; }
+    // miglior tempo su 3 giri: push dei simboli fino al rango pieno + solve
+    static double time_decode(DecoderKind kind, int K, size_t S){
+      vector<uint8_t> p((size_t)K*S); for(size_t i=0;i<p.size();++i) p[i]=(uint8_t)(i*131+7);
+      Encoder enc(p, S); vector<Fp> syms; OnlineDecoder probe(K, S);
+      while(!probe.complete()){ syms.push_back(enc.emit()); probe.push(syms.back()); }
+      double best=1e300;
+      for(int r=0;r<3;++r){ auto t0=std::chrono::steady_clock::now(); AnyDecoder d(kind, K, S); for(const auto& f:syms) d.push(f); d.solve();
+        best=min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-t0).count()); }
+      return best;
+    }
+    // Due punti densi a K fisso separano parole e XOR, uno sparso da' il peeling (pochi ms).
+    // Lo stato di util::rng viene ripristinato: la calibrazione non sposta i semi LT.
+    static DecodeCost calibrate(){
+      const auto saved=util::rng.s; DecodeCost m; const int K=64; const size_t s1=16, s2=512;
+      double t1=time_decode(DecoderKind::DENSE, K, s1), t2=time_decode(DecoderKind::DENSE, K, s2);
+      m.b=max(1e-9, (t2-t1)/((double)K*K*(double)(s2-s1)));
+      m.a=max(1e-9, (t1-m.b*K*K*(double)s1)/((double)K*K*K/64));
+      m.c=max(1e-9, time_decode(DecoderKind::PEELING, PEELING_MIN_K*2, 256)/((double)PEELING_MIN_K*2*256));
+      util::rng.s=saved; return m;
     }
+    static const DecodeCost& shared(){ static const DecodeCost m=calibrate(); return m; }
   };
 
   // Tipo di segmento: parte critica vs bulk
   enum class SegmentKind : uint8_t {
       CRITICAL,  // parte critica (es. header logico)
-      BULK       // corpo bulk (default)
+      BULK,      // corpo bulk (default)
+      LAYER      // strato UEP (spawn_layered), indice in Pkt::layer
   };
 
+  // Copiato per valore a ogni hop: niente heap, il token e' un fec::TokenHandle
+  // (src/fec/AuroraTokenHandle.hpp) e filtrarlo e' un confronto di interi
   struct Pkt{ 
       Fp fp; 
       uint32_t seq; 
-      string token_id; 
+      TokenHandle token = 0;                  // token_handle(id)
       SegmentKind kind = SegmentKind::BULK;  // default: bulk
+      uint32_t block = 0;                     // blocco sorgente (SBN) nel segmento
+      uint16_t sym = 0;                       // byte per simbolo scelti dal mittente (0 = non indicato)
+      uint8_t layer = 0;                      // strato (SegmentKind::LAYER), in ordine di offset
   };
+  static_assert(is_trivially_copyable_v<Pkt>);
 }
 
 // ===== PoD-Merkle =====
 namespace podm {
   static inline string leaf(const vector<uint8_t>& v){ return util::h64(string((const char*)v.data(), v.size())); }
+  static inline string leaf(fec::SymView v){ return util::h64(string((const char*)v.data(), v.size())); }
   static inline string h2(const string&a,const string&b){ return util::h64(a+b); }
   static inline string root(vector<string> L){ if(L.empty()) return util::h64("EMPTY"); while(L.size()>1){ vector<string> n; for(size_t i=0;i<L.size(); i+=2){ string A=L[i], B=(i+1<L.size()?L[i+1]:L[i]); n.push_back(h2(A,B)); } L.swap(n);} return L[0]; }
 }
@@ -0,0 +1,830 @@
+// aurora_fec_bench.cpp
+// Micro-benchmark del codec fountain (fec::Encoder / fec::Decoder)
+//
+// Modalita':
+//   solve  - confronta la vecchia eliminazione byte-per-bit (copia di A e rhs)
+//            con il decoder GF(2) bit-packed in place, K = 16..4096
+//   peel   - decoder denso bit-packed vs peeling + inattivazione sugli stessi simboli
+//   xor    - throughput (GB/s) di ogni kernel XOR supportato per S = 128/256 e S custom
+//   fixed  - per S = 64..1024: kernel XOR generico vs a dimensione fissa (simd::xor_for), su
+//            XOR singola, Encoder::emit() e decodifica OnlineDecoder vs OnlineDecoderT<S>
+//   emit   - costo per simbolo di Encoder::emit() e OnlineDecoder::push(), mt19937 vs SplitMix
+//   degree - overhead di ricezione (simboli per rango pieno / K) e costo di emit():
+//            deg() storico vs Robust Soliton con diversi (c, delta)
+//   sys    - latenza di decodifica senza perdite: simboli LT vs modo sistematico
+//   alloc  - allocazioni heap per simbolo su spawn -> send -> ingest -> decode
+//   batch  - spawn di payload da 1-16 MB (critical 10% + bulk 90%, overhead 1.2):
+//            emit() in sequenza vs emit_batches su 1 thread vs pool condiviso
+//   blocks - decodifica di payload da 256 KB-16 MB con 10% di perdite: decoder unico su
+//            tutti i Kt simboli vs BlockedDecoder (blocchi/sub-block) su 1 thread e sul pool
+//   sw     - flusso NERVE di messaggi piccoli, overhead 1.5, perdite 5-20%: un Token (K=1) per
+//            messaggio vs blocco LT da 16 messaggi vs finestra scorrevole (W=32); ritardo
+//            di consegna in ordine (slot di simbolo, media/p99), messaggi persi, us/messaggio
+//   mds    - kernel GF(256) split-nibble (GB/s per variante) e, per K = 1..32, simboli
+//            ricevuti per decodificare e simboli da inviare per il 99% di consegna con il 20%
+//            di perdite: LT sistematico + decoder denso vs MDS (Cauchy)
+//   rq     - codec RaptorQ-style (solo con -DAURORA_USE_RAPTORQ): overhead di ricezione
+//            e tempi di encode/decode con perdite, confrontati con LT + decoder online
+//   suite  - griglia K x S x perdita x decoder (online, dense, peel, mds): encode e decode
+//            MB/s, overhead di ricezione, picco di heap e allocazioni per simbolo, in JSON
+//            e/o CSV; con --baseline confronta con un JSON salvato ed esce con 1 se regredisce
+//            (overhead, heap, allocazioni, esito; il throughput solo con --tput-tol)
+//
+// Build: cmake --build build --target aurora_fec_bench
+// Run:   ./build/bin/aurora_fec_bench solve [S] [max_legacy_K]
+//        ./build/bin/aurora_fec_bench peel [S]
+//        ./build/bin/aurora_fec_bench xor [S]
+//        ./build/bin/aurora_fec_bench fixed [K]
+//        ./build/bin/aurora_fec_bench emit [S]
+//        ./build/bin/aurora_fec_bench degree [S] [trials]
+//        ./build/bin/aurora_fec_bench sys [S]
+//        ./build/bin/aurora_fec_bench alloc [S]
+//        ./build/bin/aurora_fec_bench batch [S]
+//        ./build/bin/aurora_fec_bench blocks [S]
+//        ./build/bin/aurora_fec_bench sw [S]
+//        ./build/bin/aurora_fec_bench mds [S] [trials]
+//        ./build/bin/aurora_fec_bench rq [S] [trials]
+//        ./build/bin/aurora_fec_bench suite [--K 16,64,...] [--S 64,...] [--loss 0,0.1,...]
+//              [--dec online,dense,peel,mds] [--reps n] [--json f] [--csv f]
+//              [--baseline f] [--tol 0.15] [--tput-tol 0.5]
+//        cmake --build build --target fec_bench_suite   (JSON/CSV in build/, baseline da
+//              -DAURORA_FEC_BASELINE=<file>, throughput con -DAURORA_FEC_TPUT_TOL=<t>)
+
+#include "aurora_extreme.hpp"
+#ifdef AURORA_USE_RAPTORQ
+#include "fec/AuroraRaptorQ.hpp"
+#endif
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Contatori globali dell'heap (modalita' alloc e suite): allocazioni, byte vivi e picco.
+// Ogni blocco porta la sua dimensione in un header da max(allineamento, 16) byte.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"  // new/delete sostituiti sopra malloc/free
+#endif
+static std::atomic<size_t> g_allocs{0}, g_live{0}, g_peak{0};
+static size_t heap_hdr(size_t al){ return al>alignof(std::max_align_t) ? al : alignof(std::max_align_t); }
+static void* heap_alloc(std::size_t n, size_t al){
+  g_allocs.fetch_add(1, std::memory_order_relaxed);
+  const size_t hdr=heap_hdr(al);
+  void* p = al>alignof(std::max_align_t) ? std::aligned_alloc(al, (n+hdr+al-1)/al*al) : std::malloc(n+hdr);
+  if(!p) throw std::bad_alloc();
+  size_t live=g_live.fetch_add(n, std::memory_order_relaxed)+n, peak=g_peak.load(std::memory_order_relaxed);
+  while(live>peak && !g_peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)){}
+  unsigned char* q=(unsigned char*)p+hdr; ((size_t*)q)[-1]=n; return q;
+}
+static void heap_free(void* q, size_t al){
+  if(!q) return;
+  g_live.fetch_sub(((size_t*)q)[-1], std::memory_order_relaxed); std::free((unsigned char*)q-heap_hdr(al));
+}
+void* operator new(std::size_t n){ return heap_alloc(n, 0); }
+void* operator new[](std::size_t n){ return heap_alloc(n, 0); }
+void* operator new(std::size_t n, std::align_val_t a){ return heap_alloc(n, (size_t)a); }
+void* operator new[](std::size_t n, std::align_val_t a){ return heap_alloc(n, (size_t)a); }
+void operator delete(void* p) noexcept { heap_free(p, 0); }
+void operator delete[](void* p) noexcept { heap_free(p, 0); }
+void operator delete(void* p, std::size_t) noexcept { heap_free(p, 0); }
+void operator delete[](void* p, std::size_t) noexcept { heap_free(p, 0); }
+void operator delete(void* p, std::align_val_t a) noexcept { heap_free(p, (size_t)a); }
+void operator delete[](void* p, std::align_val_t a) noexcept { heap_free(p, (size_t)a); }
+void operator delete(void* p, std::size_t, std::align_val_t a) noexcept { heap_free(p, (size_t)a); }
+void operator delete[](void* p, std::size_t, std::align_val_t a) noexcept { heap_free(p, (size_t)a); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace bench {
+
+// Percorso storico di fec::Decoder::solve(): una riga = vector<uint8_t> da un byte per bit,
+// deep copy di A e rhs, eliminazione byte per byte. Tenuto qui solo come riferimento.
+struct LegacyDecoder {
+  int n; size_t S; vector<vector<uint8_t>> A, rhs;
+  LegacyDecoder(int n,size_t S):n(n),S(S){}
+  void push(const fec::Fp& p){ vector<int> idx; fec::for_each_neighbour(p, n, [&](uint32_t id){ idx.push_back((int)id); }); vector<uint8_t> row(n,0); for(int id:idx) row[id]^=1; A.push_back(move(row)); rhs.push_back(p.data.to_vector()); }
+  pair<bool, vector<uint8_t>> solve(){ int m=A.size(); if(!m) return {false,{}}; vector<vector<uint8_t>> M=A; int r=0; vector<int> piv; vector<vector<uint8_t>> R=rhs;
+    for(int c=0;c<n && r<m;++c){
+      int s=-1;
+      for(int i=r;i<m;++i){ if(M[i][c]){ s=i; break; } }
+      if(s==-1) continue;
+      swap(M[r],M[s]); swap(R[r],R[s]);
+      for(int i=0;i<m;++i){
+        if(i==r || !M[i][c]) continue;
+        for(int j=c;j<n;++j){ M[i][j]^=M[r][j]; }
+        for(size_t b=0;b<S;++b){ R[i][b]^=R[r][b]; }
+      }
+      piv.push_back(c); r++;
+    }
+    if((int)piv.size()<n) return {false,{}};
+    vector<vector<uint8_t>> sym(n, vector<uint8_t>(S,0));
+    for(int pi=(int)piv.size()-1; pi>=0; --pi){
+      int c=piv[pi], rr=pi;
+      for(int j=c+1;j<n;++j){ if(M[rr][j]) for(size_t b=0;b<S;++b) R[rr][b]^=sym[j][b]; }
+      sym[c]=R[rr];
+    }
+    vector<uint8_t> out; out.reserve(n*S); for(int i=0;i<n;++i) out.insert(out.end(), sym[i].begin(), sym[i].end()); return {true,out};
+  }
+};
+
+static vector<uint8_t> make_payload(size_t n, uint32_t seed){
+  mt19937 g(seed); vector<uint8_t> v(n); for(auto& b:v) b=(uint8_t)g(); return v;
+}
+
+template<typename F>
+static double time_ms(F&& f){
+  auto t0=chrono::steady_clock::now(); f();
+  return chrono::duration<double, milli>(chrono::steady_clock::now()-t0).count();
+}
+
+// Genera simboli finche' il decoder bit-packed risolve: entrambi i decoder
+// lavorano poi sullo stesso identico insieme di simboli.
+static vector<fec::Fp> symbols_for_full_rank(fec::Encoder& enc, size_t S){
+  int K=enc.N(); vector<fec::Fp> syms; syms.reserve(K*2);
+  fec::Decoder d(K,S);
+  for(int i=0;i<K;++i){ syms.push_back(enc.emit()); d.push(syms.back()); }
+  // push() dopo un solve() fallito resta valido: il sistema e' gia' ridotto
+  while(!d.solve().first)
+    for(int i=0;i<max(1,K/16);++i){ syms.push_back(enc.emit()); d.push(syms.back()); }
+  return syms;
+}
+
+static int run_solve(size_t S, int max_legacy_K){
+  cout << "[BENCH][SOLVE] S=" << S << " legacy fino a K=" << max_legacy_K << "\n";
+  cout << left << setw(7) << "K" << setw(9) << "symbols"
+       << setw(14) << "legacy_ms" << setw(14) << "packed_ms" << setw(10) << "speedup"
+       << setw(14) << "legacy_MB" << "packed_MB" << "\n";
+  for(int K=16; K<=4096; K*=2){
+    auto payload=make_payload((size_t)K*S, (uint32_t)K);
+    fec::Encoder enc(payload, S);
+    auto syms=symbols_for_full_rank(enc, S);
+    size_t m=syms.size();
+
+    fec::Decoder packed(K,S); for(auto& p:syms) packed.push(p);
+    bool ok_packed=false;
+    double t_packed=time_ms([&]{ auto r=packed.solve(); ok_packed = r.first && r.second==payload; });
+    // memoria del sistema: A bit-packed + rhs, nessuna copia
+    double mb_packed=(m*packed.W*8.0 + m*S)/1e6;
+
+    cout << left << setw(7) << K << setw(9) << m << fixed << setprecision(2);
+    if(K<=max_legacy_K){
+      LegacyDecoder legacy(K,S); for(auto& p:syms) legacy.push(p);
+      bool ok_legacy=false;
+      double t_legacy=time_ms([&]{ auto r=legacy.solve(); ok_legacy = r.first && r.second==payload; });
+      // A e rhs originali + le due copie fatte da solve()
+      double mb_legacy=2.0*(m*(double)K + m*(double)S)/1e6;
+      cout << setw(14) << t_legacy << setw(14) << t_packed
+           << setw(10) << (t_legacy/max(1e-6,t_packed)) << setw(14) << mb_legacy << mb_packed;
+      if(!ok_legacy) cout << "  [legacy FAIL]";
+    } else {
+      cout << setw(14) << "-" << setw(14) << t_packed << setw(10) << "-" << setw(14) << "-" << mb_packed;
+    }
+    if(!ok_packed) cout << "  [packed FAIL]";
+    cout << "\n";
+  }
+  return 0;
+}
+
+static int run_peel(size_t S){
+  cout << "[BENCH][PEEL] S=" << S << "\n";
+  cout << left << setw(7) << "K" << setw(9) << "symbols"
+       << setw(14) << "dense_ms" << setw(14) << "peeling_ms" << "speedup" << "\n";
+  for(int K=16; K<=4096; K*=2){
+    auto payload=make_payload((size_t)K*S, (uint32_t)K);
+    fec::Encoder enc(payload, S);
+    auto syms=symbols_for_full_rank(enc, S);
+
+    fec::Decoder dense(K,S); for(auto& p:syms) dense.push(p);
+    fec::PeelingDecoder peel(K,S); for(auto& p:syms) peel.push(p);
+    bool ok_dense=false, ok_peel=false;
+    double t_dense=time_ms([&]{ auto r=dense.solve(); ok_dense = r.first && r.second==payload; });
+    double t_peel=time_ms([&]{ auto r=peel.solve(); ok_peel = r.first && r.second==payload; });
+    cout << left << setw(7) << K << setw(9) << syms.size() << fixed << setprecision(2)
+         << setw(14) << t_dense << setw(14) << t_peel << (t_dense/max(1e-6,t_peel));
+    if(!ok_dense) cout << "  [dense FAIL]";
+    if(!ok_peel) cout << "  [peeling FAIL]";
+    cout << "\n";
+  }
+  return 0;
+}
+
+// Un set di simboli piu' grande della L1: XOR a rotazione come in Encoder::emit()
+static int run_xor(size_t S_extra){
+  vector<size_t> sizes{128, 256}; if(S_extra && S_extra!=128 && S_extra!=256) sizes.push_back(S_extra);
+  cout << "[BENCH][XOR] kernel selezionato: " << fec::simd::xor_selected().name << "\n";
+  cout << left << setw(10) << "kernel" << setw(7) << "S" << setw(12) << "GB/s" << "ns/xor" << "\n";
+  for(size_t S : sizes){
+    const size_t nsym=1024; auto pool=make_payload(nsym*S, (uint32_t)S); vector<uint8_t> mix(S,0);
+    const size_t iters=max<size_t>(1, (size_t)(256u<<20)/S);  // ~256 MB per variante
+    for(const auto& k : fec::simd::xor_kernels()){
+      if(!k.supported){ cout << left << setw(10) << k.name << setw(7) << S << "non supportato\n"; continue; }
+      for(size_t i=0;i<nsym;++i) k.fn(mix.data(), pool.data()+i*S, S);  // warm-up
+      double ms=time_ms([&]{ for(size_t i=0;i<iters;++i) k.fn(mix.data(), pool.data()+(i%nsym)*S, S); });
+      volatile uint8_t sink=mix[0]; (void)sink;
+      double gbs=(double)iters*S/(ms*1e6);
+      cout << left << setw(10) << k.name << setw(7) << S << fixed << setprecision(2)
+           << setw(12) << gbs << (ms*1e6/iters) << "\n";
+    }
+  }
+  return 0;
+}
+
+// Kernel generico (xor_selected) contro quello a dimensione fissa per ogni S in FIXED_SIZES:
+// XOR singola, Encoder::emit() e push+solve di OnlineDecoder<0> contro OnlineDecoderT<S>
+static int run_fixed(int K){
+  const fec::simd::XorFn generic=fec::simd::xor_selected().fn;
+  cout << "[BENCH][FIXED] kernel " << fec::simd::xor_selected().name << " K=" << K << " (min di 5 ripetizioni)\n";
+  cout << left << setw(7) << "S" << setw(11) << "xor_gen" << setw(11) << "xor_fix" << setw(12) << "emit_gen"
+       << setw(12) << "emit_fix" << setw(12) << "dec_gen" << setw(12) << "dec_fix" << "speedup(dec)\n";
+  auto best=[](auto&& f){ double b=1e300; for(int r=0;r<5;++r) b=min(b, time_ms(f)); return b; };
+  for(size_t S : fec::simd::FIXED_SIZES){
+    auto payload=make_payload((size_t)K*S, (uint32_t)S);
+    const size_t iters=max<size_t>(1, (size_t)(64u<<20)/S); fec::SymbolSlab mslab(S); uint8_t* mix=mslab.alloc();   // slot allineato come quelli dell'encoder
+    const fec::simd::XorFn fix=fec::simd::xor_for(S);
+    double x_gen=best([&]{ for(size_t i=0;i<iters;++i) generic(mix, payload.data()+(i%K)*S, S); });
+    double x_fix=best([&]{ for(size_t i=0;i<iters;++i) fix(mix, payload.data()+(i%K)*S, S); });
+    volatile uint8_t sink=mix[0]; (void)sink;
+    const int nsym=K*2;
+    auto emit_ms=[&](fec::simd::XorFn xr){ return best([&]{ util::rng.s=0xF1ED; fec::Encoder enc(payload, S); enc.xr=xr;
+      for(int i=0;i<nsym;++i) enc.emit(); }); };
+    double e_gen=emit_ms(generic), e_fix=emit_ms(fix);
+    util::rng.s=0xF1ED; fec::Encoder enc(payload, S); vector<fec::Fp> syms;
+    { fec::OnlineDecoder probe(K, S); while(!probe.complete()){ syms.push_back(enc.emit()); probe.push(syms.back()); } }
+    vector<uint8_t> ref;
+    double d_gen=best([&]{ fec::OnlineDecoder d(K, S); d.xr=generic; for(auto& f:syms) d.push(f); ref=d.solve().second; });
+    double d_fix=fec::with_symbol_size(S, [&](auto sz){
+      vector<uint8_t> got; double ms=best([&]{ fec::OnlineDecoderT<sz()> d(K, S); for(auto& f:syms) d.push(f); got=d.solve().second; });
+      if(got!=ref || !equal(payload.begin(), payload.end(), got.begin())){ cout << "ERRORE: decode diverso S=" << S << "\n"; ms=-1; }
+      return ms; });
+    if(d_fix<0) return 1;
+    cout << left << setw(7) << S << fixed << setprecision(1) << setw(11) << x_gen*1e6/iters << setw(11) << x_fix*1e6/iters
+         << setw(12) << e_gen*1e6/nsym << setw(12) << e_fix*1e6/nsym << setprecision(3) << setw(12) << d_gen << setw(12) << d_fix
+         << setprecision(2) << d_gen/d_fix << "x\n";
+  }
+  cout << "  (xor/emit in ns per simbolo, dec in ms per push+solve di K simboli)\n";
+  return 0;
+}
+
+static int run_emit(size_t S){
+  cout << "[BENCH][EMIT] S=" << S << "\n";
+  cout << left << setw(7) << "K" << setw(10) << "gen" << setw(14) << "emit_ns" << "push_ns" << "\n";
+  for(int K : {64, 256, 1024}){
+    auto payload=make_payload((size_t)K*S, (uint32_t)K);
+    for(uint32_t gen : {fec::FP_GEN_MT19937, fec::FP_GEN_SPLITMIX}){
+      fec::Encoder enc(payload, S); enc.gen=gen;
+      const int nsym=K*2; vector<fec::Fp> syms; syms.reserve(nsym);
+      double t_emit=time_ms([&]{ for(int i=0;i<nsym;++i) syms.push_back(enc.emit()); });
+      fec::OnlineDecoder dec(K, S);
+      double t_push=time_ms([&]{ for(auto& p:syms) dec.push(p); });
+      cout << left << setw(7) << K << setw(10) << (gen==fec::FP_GEN_MT19937 ? "mt19937" : "splitmix")
+           << fixed << setprecision(1) << setw(14) << t_emit*1e6/nsym << t_push*1e6/nsym;
+      if(!dec.complete()) cout << "  [rank " << dec.rank() << "/" << K << "]";
+      cout << "\n";
+    }
+  }
+  return 0;
+}
+
+struct DegreeConfig { const char* name; fec::DegreeDist dist; double c, delta; };
+
+static int run_degree(size_t S, int trials){
+  const DegreeConfig cfgs[] = {
+    {"legacy",        fec::DegreeDist::LEGACY,         0,    0   },
+    {"rs c=.03 d=.5", fec::DegreeDist::ROBUST_SOLITON, 0.03, 0.5 },
+    {"rs c=.1 d=.5",  fec::DegreeDist::ROBUST_SOLITON, 0.1,  0.5 },
+    {"rs c=.1 d=.05", fec::DegreeDist::ROBUST_SOLITON, 0.1,  0.05},
+    {"rs c=.3 d=.5",  fec::DegreeDist::ROBUST_SOLITON, 0.3,  0.5 },
+  };
+  cout << "[BENCH][DEGREE] S=" << S << " trials=" << trials << " (decoder online, rango pieno)\n";
+  cout << left << setw(7) << "K" << setw(16) << "dist" << setw(12) << "overhead" << setw(12) << "p95"
+       << setw(12) << "max" << setw(10) << "avg_deg" << setw(10) << "emit_ns" << "over_pool" << "\n";
+  for(int K : {4, 16, 64, 128, 256, 1024}){
+    auto payload=make_payload((size_t)K*S, (uint32_t)K);
+    const int pool=fec::lt_pool_size(K);
+    cout << "K=" << K << " pool=" << pool << " (prima K*3=" << K*3 << ")\n";
+    for(const auto& cfg : cfgs){
+      vector<double> ov; double deg_sum=0, emit_ms=0; long nsym=0;
+      for(int t=0;t<trials;++t){
+        fec::Encoder enc(payload, S);
+        if(cfg.dist==fec::DegreeDist::LEGACY) enc.dist=fec::DegreeDist::LEGACY; else enc.set_robust_soliton(cfg.c, cfg.delta);
+        fec::OnlineDecoder dec(K, S); int used=0;
+        while(!dec.complete() && used<K*8){
+          fec::Fp fp; emit_ms+=time_ms([&]{ fp=enc.emit(); });
+          deg_sum+=fec::fp_degree(fp); ++nsym; ++used; dec.push(fp);
+        }
+        ov.push_back((double)used/K);
+      }
+      sort(ov.begin(), ov.end());
+      double mean=0; for(double x:ov) mean+=x; mean/=ov.size();
+      cout << left << setw(7) << K << setw(16) << cfg.name << fixed << setprecision(3)
+           << setw(12) << mean << setw(12) << ov[(size_t)(0.95*(ov.size()-1))] << setw(12) << ov.back()
+           << setprecision(2) << setw(10) << deg_sum/nsym << setprecision(0) << setw(10) << emit_ms*1e6/nsym
+           << (size_t)(ov.end()-upper_bound(ov.begin(), ov.end(), (double)pool/K)) << "/" << trials << "\n";
+    }
+  }
+  return 0;
+}
+
+// Canale pulito: i primi simboli ricevuti fino al rango pieno, push + solve cronometrati
+static int run_sys(size_t S){
+  cout << "[BENCH][SYS] S=" << S << " (decoder online, nessuna perdita)\n";
+  cout << left << setw(7) << "K" << setw(10) << "lt_syms" << setw(14) << "lt_ms" << setw(14) << "sys_ms" << "speedup" << "\n";
+  for(int K=16; K<=4096; K*=2){
+    auto payload=make_payload((size_t)K*S, (uint32_t)K);
+    double t[2]; size_t used[2]; bool ok[2];
+    for(int sys=0; sys<2; ++sys){
+      fec::Encoder enc(payload, S); enc.systematic = sys==1;
+      vector<fec::Fp> syms; fec::OnlineDecoder probe(K, S);
+      while(!probe.complete()){ syms.push_back(enc.emit()); probe.push(syms.back()); }
+      fec::OnlineDecoder dec(K, S);
+      t[sys]=time_ms([&]{ for(auto& p:syms) dec.push(p); auto r=dec.solve(); ok[sys]=r.first && r.second==payload; });
+      used[sys]=syms.size();
+    }
+    cout << left << setw(7) << K << setw(10) << used[0] << fixed << setprecision(3)
+         << setw(14) << t[0] << setw(14) << t[1] << setprecision(1) << t[0]/max(1e-6,t[1]);
+    if(!ok[0] || !ok[1]) cout << "  [FAIL]";
+    cout << "\n";
+  }
+  return 0;
+}
+
+// Percorso di aurora_x: spawn (emit nel pool del mittente), send (copia del Pkt come
+// Node::send_one verso l'inbox), ingest (inbox -> buf), decode (OnlineDecoder)
+static int run_alloc(size_t S){
+  cout << "[BENCH][ALLOC] S=" << S << " (allocazioni per simbolo)\n";
+  cout << left << setw(7) << "K" << setw(9) << "symbols" << setw(10) << "spawn" << setw(10) << "send"
+       << setw(10) << "ingest" << setw(10) << "decode" << "total" << "\n";
+  const fec::TokenHandle token=fec::token_handle(util::h64("bench-token"));
+  for(int K : {16, 128, 1024}){
+    auto payload=make_payload((size_t)K*S, (uint32_t)K);
+    const int nsym=fec::lt_pool_size(K);
+    vector<fec::Pkt> src, inbox, buf; src.reserve(nsym); inbox.reserve(nsym); buf.reserve(nsym);
+    size_t a0=g_allocs.load();
+    fec::Encoder enc(payload, S); enc.systematic=true; enc.reserve(nsym);
+    for(int i=0;i<nsym;++i) src.push_back({enc.emit(), (uint32_t)i, token});
+    size_t a1=g_allocs.load();
+    for(size_t i=0;i<src.size();++i){ const auto& pkt=src[i]; inbox.push_back(pkt); }
+    size_t a2=g_allocs.load();
+    for(auto& p:inbox){ buf.push_back(std::move(p)); }
+    inbox.clear();
+    size_t a3=g_allocs.load();
+    fec::OnlineDecoder dec(K, S); bool ok=false;
+    for(auto& p:buf){ dec.push(p.fp); if(dec.complete()){ ok=dec.solve().second==payload; break; } }
+    size_t a4=g_allocs.load();
+    auto per=[&](size_t a, size_t b){ return (double)(b-a)/nsym; };
+    cout << left << setw(7) << K << setw(9) << nsym << fixed << setprecision(2)
+         << setw(10) << per(a0,a1) << setw(10) << per(a1,a2) << setw(10) << per(a2,a3)
+         << setw(10) << per(a3,a4) << per(a0,a4) << (ok ? "" : "  [FAIL]") << "\n";
+  }
+  return 0;
+}
+
+// Come AlienFountainOrganism::spawn: due encoder sistematici, costruzione compresa nei tempi
+static int run_batch(size_t S){
+  fec::WorkerPool single(1); fec::WorkerPool& pool=fec::WorkerPool::shared();
+  cout << "[BENCH][BATCH] S=" << S << " threads=" << pool.threads() << " (critical 10% + bulk 90%, overhead 1.2)\n";
+  cout << left << setw(8) << "MB" << setw(10) << "symbols" << setw(12) << "emit_ms" << setw(12) << "batch1_ms"
+       << setw(12) << "batchN_ms" << "speedup" << "\n";
+  for(size_t mb : {1, 4, 16}){
+    auto payload=make_payload(mb<<20, (uint32_t)mb);
+    size_t cut=payload.size()/10;
+    vector<uint8_t> crit(payload.begin(), payload.begin()+cut), bulk(payload.begin()+cut, payload.end());
+    size_t nc=0, nb=0; double t[3]; bool same=true; vector<fec::Fp> ref;
+    for(int m=0;m<3;++m){
+      util::rng.s=0xC0FFEEBEEFULL; vector<fec::Fp> out;
+      t[m]=time_ms([&]{
+        fec::Encoder ec(crit, S), eb(bulk, S); ec.systematic=eb.systematic=true;
+        nc=(size_t)ceil(ec.N()*1.2); nb=(size_t)ceil(eb.N()*1.2); out.resize(nc+nb);
+        if(m==0){ ec.reserve(nc); eb.reserve(nb); for(size_t i=0;i<nc;++i) out[i]=ec.emit(); for(size_t i=0;i<nb;++i) out[nc+i]=eb.emit(); }
+        else fec::emit_batches({{&ec, nc, out.data()}, {&eb, nb, out.data()+nc}}, m==1 ? single : pool);
+      });
+      if(m==0) ref=out; else for(size_t i=0;i<out.size();++i) same&=out[i].seed==ref[i].seed && out[i].deg==ref[i].deg;
+    }
+    cout << left << setw(8) << mb << setw(10) << nc+nb << fixed << setprecision(2) << setw(12) << t[0]
+         << setw(12) << t[1] << setw(12) << t[2] << setprecision(1) << t[0]/max(1e-6,t[2]) << (same ? "" : "  [MISMATCH]") << "\n";
+  }
+  return 0;
+}
+
+// Simboli pre-generati (non nei tempi), 10% di perdita; il decoder unico e' limitato a
+// Kt <= 8192 (memoria del sistema denso)
+static int run_blocks(size_t S){
+  fec::WorkerPool single(1); fec::WorkerPool& pool=fec::WorkerPool::shared();
+  cout << "[BENCH][BLOCKS] S=" << S << " threads=" << pool.threads() << " (10% perdite)\n";
+  cout << left << setw(8) << "KB" << setw(8) << "Kt" << setw(5) << "Z" << setw(5) << "N" << setw(12) << "single_ms"
+       << setw(12) << "block1_ms" << setw(12) << "blockN_ms" << "speedup" << "\n";
+  for(size_t kb : {256, 1024, 4096, 16384}){
+    auto payload=make_payload(kb<<10, (uint32_t)kb);
+    auto lay=fec::block_layout(payload.size(), S);
+    mt19937 rng((uint32_t)kb); bool fail=false;
+    vector<fec::Encoder> encs; vector<vector<fec::Fp>> syms(lay.Z);   // i Fp sono viste nello slab dell'encoder
+    for(uint32_t b=0;b<lay.Z;++b){
+      encs.emplace_back(payload.data()+lay.offset(b), lay.bytes(b), S);
+      for(uint32_t i=0;i<lay.K(b)*2;++i){ auto f=encs[b].emit(); if(rng()%10) syms[b].push_back(move(f)); }
+    }
+    double t_single=-1;
+    if(lay.Kt<=8192){
+      fec::Encoder enc(payload, S); vector<fec::Fp> all;
+      for(uint32_t i=0;i<lay.Kt*2;++i){ auto f=enc.emit(); if(rng()%10) all.push_back(move(f)); }
+      t_single=time_ms([&]{
+        fec::AnyDecoder dec(fec::pick_decoder((int)lay.Kt), (int)lay.Kt, S); pair<bool, vector<uint8_t>> r;
+        for(size_t i=0;i<all.size() && !r.first;++i){ dec.push(all[i]); if(dec.ready()) r=dec.solve(); }
+        fail|=!r.first || !equal(payload.begin(), payload.end(), r.second.begin());
+      });
+    }
+    double t[2];
+    for(int m=0;m<2;++m){
+      t[m]=time_ms([&]{
+        fec::BlockedDecoder dec(lay); vector<size_t> next(lay.Z, 0);
+        while(!dec.complete()){
+          bool more=false;
+          for(uint32_t b=0;b<lay.Z;++b){
+            if(dec.block_done(b)) continue;
+            for(; next[b]<syms[b].size() && !dec.ready(b); ++next[b]) dec.push(b, syms[b][next[b]]);
+            more|=next[b]<syms[b].size();
+          }
+          dec.solve_ready({}, m==0 ? single : pool);
+          if(!more && !dec.complete()){ fail=true; break; }
+        }
+        fail|=dec.out!=payload;
+      });
+    }
+    cout << left << setw(8) << kb << setw(8) << lay.Kt << setw(5) << lay.Z << setw(5) << lay.N << fixed << setprecision(2);
+    if(t_single<0) cout << setw(12) << "-"; else cout << setw(12) << t_single;
+    cout << setw(12) << t[0] << setw(12) << t[1] << setprecision(1) << (t_single<0 ? t[0] : t_single)/max(1e-6,t[1])
+         << (fail ? "  [FAIL]" : "") << "\n";
+  }
+  return 0;
+}
+
+// Un simbolo per slot, perdite i.i.d.; avail[i] = slot in cui il messaggio i diventa noto,
+// la consegna in ordine avviene al massimo degli avail del prefisso (i persi non bloccano)
+static int run_sw(size_t S){
+  const int M=20000, B=16; const double ov=1.5; const size_t NONE=SIZE_MAX;
+  cout << "[BENCH][SW] S=" << S << " messaggi=" << M << " overhead=" << ov << " (ritardo in slot di simbolo)\n";
+  cout << left << setw(7) << "loss" << setw(10) << "mode" << setw(10) << "mean" << setw(8) << "p99" << setw(10) << "lost%" << "us/msg" << "\n";
+  vector<vector<uint8_t>> msgs; for(int i=0;i<M;++i) msgs.push_back(make_payload(S-2, (uint32_t)i));
+  auto report=[&](double loss, const char* mode, const vector<size_t>& sent, const vector<size_t>& avail, double ms){
+    vector<size_t> d; size_t hol=0, lost=0;
+    for(int i=0;i<M;++i){ if(avail[i]==NONE){ ++lost; continue; } hol=max(hol, avail[i]); d.push_back(hol-sent[i]); }
+    sort(d.begin(), d.end()); double mean=0; for(auto x:d) mean+=(double)x; mean/=max<size_t>(1, d.size());
+    cout << left << setw(7) << loss << setw(10) << mode << fixed << setprecision(2) << setw(10) << mean << setw(8) << (d.empty() ? 0 : d[d.size()*99/100])
+         << setw(10) << 100.0*lost/M << setprecision(2) << 1000.0*ms/M << "\n";
+  };
+  for(double loss : {0.05, 0.10, 0.20}){
+    vector<size_t> sent(M), avail(M, NONE);
+    // Token per messaggio: K=1, copie extra a credito
+    { mt19937 rng(1); size_t slot=0; double credit=0;
+      double ms=time_ms([&]{ for(int i=0;i<M;++i){ sent[i]=slot; credit+=ov; for(; credit>=1.0; credit-=1.0, ++slot) if(avail[i]==NONE && uniform_real_distribution<>(0,1)(rng)>=loss) avail[i]=slot; } });
+      report(loss, "token", sent, avail, ms); }
+    // Blocco LT sistematico da B messaggi, B*ov simboli
+    { mt19937 rng(1); size_t slot=0; fill(avail.begin(), avail.end(), NONE);
+      double ms=time_ms([&]{
+        for(int b=0;b<M;b+=B){
+          vector<uint8_t> blk; for(int i=b;i<b+B;++i){ vector<uint8_t> m(S, 0); copy(msgs[i].begin(), msgs[i].end(), m.begin()); blk.insert(blk.end(), m.begin(), m.end()); }
+          fec::Encoder enc(blk, S); enc.systematic=true; fec::AnyDecoder dec(fec::pick_decoder(B), B, S); bool done=false;
+          for(int k=0;k<(int)ceil(B*ov);++k, ++slot){
+            fec::Fp f=enc.emit(); if(k<B) sent[b+k]=slot;
+            if(uniform_real_distribution<>(0,1)(rng)<loss) continue;
+            if(k<B && avail[b+k]==NONE) avail[b+k]=slot;
+            if(!done){ dec.push(f); if(dec.ready() && dec.solve().first){ done=true; for(int i=b;i<b+B;++i) if(avail[i]==NONE) avail[i]=slot; } }
+          }
+        }
+      });
+      report(loss, "block16", sent, avail, ms); }
+    // Finestra scorrevole
+    { mt19937 rng(1); size_t slot=0; fill(avail.begin(), avail.end(), NONE);
+      fec::SlidingWindowEncoder enc(S, 32); fec::SlidingWindowDecoder dec(S, 32); double credit=0;
+      auto send=[&](const fec::SwSymbol& sym){
+        if(uniform_real_distribution<>(0,1)(rng)>=loss) for(auto& d : dec.push(sym)) if(!d.lost) avail[d.seq]=slot;
+        ++slot; };
+      double ms=time_ms([&]{ for(int i=0;i<M;++i){ sent[i]=slot; send(enc.push(msgs[i])); for(credit+=ov-1.0; credit>=1.0; credit-=1.0) send(enc.repair()); } });
+      report(loss, "sliding", sent, avail, ms); }
+  }
+  return 0;
+}
+
+// Simboli ricevuti in ordine d'invio con il 20% di perdite: "need" = simboli ricevuti fino alla
+// decodifica, "send99" = simboli da inviare perche' il 99% delle prove decodifichi
+static int run_mds(size_t S, int trials){
+  cout << "[BENCH][MDS] S=" << S << " (kernel selezionato: " << fec::simd::gf_selected().name << ")\n";
+  const fec::Gf256& g=fec::gf256(); auto a=make_payload(1<<16, 1), b=make_payload(1<<16, 2);
+  for(const auto& k : fec::simd::gf_kernels()){
+    if(!k.supported) continue;
+    const int reps=2000;
+    double ms=time_ms([&]{ for(int r=0;r<reps;++r) k.mul_add(a.data(), b.data(), g.nib[2+r%250], b.size()); });
+    cout << "  mul_add " << left << setw(10) << k.name << fixed << setprecision(2) << (double)reps*b.size()/ms/1e6 << " GB/s\n";
+  }
+  cout << left << setw(5) << "K" << setw(10) << "lt_need" << setw(10) << "mds_need" << setw(10) << "lt_send99" << setw(11) << "mds_send99"
+       << setw(10) << "lt_us" << "mds_us" << "\n";
+  for(int K : {1, 2, 3, 4, 8, 16, 32}){
+    auto payload=make_payload((size_t)K*S, (uint32_t)K); double need[2]={0, 0}, us[2]={0, 0}; vector<int> sent[2]; bool fail=false;
+    for(int m=0;m<2;++m) for(int t=0;t<trials;++t){
+      mt19937 rng((uint32_t)t); fec::Encoder enc(payload, S); enc.systematic=true; enc.mds=m==1;
+      vector<pair<int, fec::Fp>> rx; for(int i=0;i<8*K+16;++i){ fec::Fp f=enc.emit(); if(rng()%5) rx.push_back({i, f}); }
+      fec::AnyDecoder dec(m ? fec::DecoderKind::MDS : fec::DecoderKind::DENSE, K, S); size_t i=0; pair<bool, vector<uint8_t>> r;
+      us[m]+=1000.0*time_ms([&]{ for(; i<rx.size() && !r.first; ++i){ dec.push(rx[i].second); if(dec.ready()) r=dec.solve(); } });
+      fail|=!r.first || r.second!=payload; need[m]+=(double)i;
+      sent[m].push_back(i ? rx[i-1].first+1 : 0);
+    }
+    for(auto& v : sent) sort(v.begin(), v.end());
+    cout << left << setw(5) << K << fixed << setprecision(2) << setw(10) << need[0]/trials << setw(10) << need[1]/trials
+         << setw(10) << sent[0][sent[0].size()*99/100] << setw(11) << sent[1][sent[1].size()*99/100]
+         << setw(10) << us[0]/trials << us[1]/trials << (fail ? "  [FAIL]" : "") << "\n";
+  }
+  return 0;
+}
+
+#ifdef AURORA_USE_RAPTORQ
+// Simboli in ordine casuale (50% di perdita sui sorgenti): RQ tenta decode() da K in su,
+// LT spinge nel decoder online fino al rango pieno
+static int run_rq(size_t S, int trials){
+  cout << "[BENCH][RQ] S=" << S << " trials=" << trials << " (ordine casuale, perdite)\n";
+  cout << left << setw(7) << "K" << setw(10) << "rq_over" << setw(10) << "rq_max" << setw(10) << "lt_over"
+       << setw(10) << "lt_max" << setw(12) << "rq_enc_ms" << setw(12) << "rq_dec_ms" << "lt_dec_ms" << "\n";
+  aurora::fec::AuroraRaptorQ rq;
+  for(int K : {16, 64, 256, 1024, 4096}){
+    auto payload=make_payload((size_t)K*S, (uint32_t)K);
+    double rq_sum=0, rq_max=0, lt_sum=0, lt_max=0, enc_ms=0, rq_ms=0, lt_ms=0; bool fail=false;
+    for(int t=0;t<trials;++t){
+      mt19937 rng(t);
+      vector<aurora::fec::EncodedSymbol> syms;
+      enc_ms+=time_ms([&]{ syms=rq.encode_all(payload.data(), payload.size(), S, (uint32_t)K); });
+      shuffle(syms.begin(), syms.end(), rng);
+      auto dec=rq.make_decoder(payload.size(), S); optional<vector<uint8_t>> out; size_t i=0;
+      rq_ms+=time_ms([&]{ for(; i<syms.size() && !out; ++i){ dec->add(syms[i]); if(dec->ready()) out=dec->decode(); } });
+      fail|=!out || *out!=payload;
+      rq_sum+=(double)i/K; rq_max=max(rq_max, (double)i/K);
+
+      fec::Encoder enc(payload, S); enc.systematic=true;
+      vector<fec::Fp> lt; for(int j=0;j<2*K;++j) lt.push_back(enc.emit());
+      shuffle(lt.begin(), lt.end(), rng);
+      fec::OnlineDecoder od(K, S); size_t used=0; pair<bool, vector<uint8_t>> r;
+      lt_ms+=time_ms([&]{
+        for(; used<lt.size() && !od.complete(); ++used) od.push(lt[used]);
+        while(!od.complete()){ od.push(enc.emit()); ++used; }
+        r=od.solve();
+      });
+      fail|=!r.first || r.second!=payload;
+      lt_sum+=(double)used/K; lt_max=max(lt_max, (double)used/K);
+    }
+    cout << left << setw(7) << K << fixed << setprecision(3) << setw(10) << rq_sum/trials << setw(10) << rq_max
+         << setw(10) << lt_sum/trials << setw(10) << lt_max << setprecision(2) << setw(12) << enc_ms/trials
+         << setw(12) << rq_ms/trials << lt_ms/trials << (fail ? "  [FAIL]" : "") << "\n";
+  }
+  return 0;
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// Suite di regressione: una riga per (decoder, K, S, perdita). I simboli ricevuti sono
+// fissati una volta (encoder sistematico, MDS per il decoder mds, perdite i.i.d. con seme
+// fisso) finche' il sistema ha rango pieno; poi si misurano separatamente encode (costruzione
+// + emit dei simboli inviati) e decode (push dei ricevuti + solve). Ogni misura ripete
+// l'operazione per almeno SUITE_MIN_MS e tiene il migliore di reps giri: il minimo e' la
+// statistica meno sensibile al rumore della macchina per il confronto col baseline.
+struct SuiteRow{
+  string dec; int K=0; size_t S=0; double loss=0;
+  double enc_mbps=0, dec_mbps=0, overhead=0, peak_kb=0, allocs_per_sym=0; bool ok=false;
+};
+constexpr double SUITE_MIN_MS=20.0;
+
+template<typename F>
+static double best_ms(int reps, F&& f){
+  double best=1e300;
+  for(int r=0;r<max(1, reps);++r){
+    int n=0; double t=0;
+    do{ t+=time_ms(f); ++n; } while(t<SUITE_MIN_MS);
+    best=min(best, t/n);
+  }
+  return best;
+}
+
+template<typename D>
+static pair<bool, vector<uint8_t>> suite_decode(int K, size_t S, const vector<fec::Fp>& rx){
+  D d(K, S); for(const auto& p:rx) d.push(p); return d.solve();
+}
+
+static pair<bool, vector<uint8_t>> suite_decode(const string& dec, int K, size_t S, const vector<fec::Fp>& rx){
+  if(dec=="online") return suite_decode<fec::OnlineDecoder>(K, S, rx);
+  if(dec=="dense") return suite_decode<fec::Decoder>(K, S, rx);
+  if(dec=="peel") return suite_decode<fec::PeelingDecoder>(K, S, rx);
+  return suite_decode<fec::MdsDecoder>(K, S, rx);
+}
+
+static SuiteRow suite_case(const string& dec, int K, size_t S, double loss, int reps){
+  SuiteRow row{dec, K, S, loss};
+  auto payload=make_payload((size_t)K*S, (uint32_t)(K*31+S));
+  const bool mds=dec=="mds";
+  auto make_enc=[&]{ fec::Encoder e(payload, S); e.systematic=true; e.mds=mds; return e; };
+  // simboli inviati/ricevuti: il rango pieno lo dice il decoder online (esatto su GF(2)) o l'MDS.
+  // Semi LT fissati: overhead e allocazioni sono deterministici e confrontabili col baseline
+  util::rng.s=0xC0FFEEBEEFULL+(uint64_t)K*S;
+  fec::Encoder enc=make_enc(); mt19937 rng((uint32_t)(K+S)+(uint32_t)(loss*1000));
+  vector<fec::Fp> rx; size_t sent=0;
+  fec::OnlineDecoder probe(mds ? 0 : K, S); fec::MdsDecoder mprobe(mds ? K : 0, S);
+  const size_t max_sent=mds ? fec::MDS_MAX_ESI : (size_t)K*8+64;
+  while(!(mds ? mprobe.complete() : probe.complete()) && sent<max_sent){
+    fec::Fp f=enc.emit(); ++sent;
+    if(uniform_real_distribution<>(0, 1)(rng)<loss) continue;
+    rx.push_back(f); if(mds) mprobe.push(f); else probe.push(f);
+  }
+  row.overhead=(double)rx.size()/K;
+  // una passata per allocazioni e picco di heap
+  const size_t a0=g_allocs.load(), live0=g_live.load(); g_peak.store(live0);
+  { fec::Encoder e=make_enc(); for(size_t i=0;i<sent;++i) e.emit(); auto r=suite_decode(dec, K, S, rx); row.ok=r.first && r.second==payload; }
+  row.allocs_per_sym=(double)(g_allocs.load()-a0)/max<size_t>(1, sent);
+  row.peak_kb=(double)(g_peak.load()-live0)/1024.0;
+  double t_enc=best_ms(reps, [&]{ fec::Encoder e=make_enc(); for(size_t i=0;i<sent;++i) e.emit(); });
+  double t_dec=best_ms(reps, [&]{ row.ok&=suite_decode(dec, K, S, rx).first; });
+  row.enc_mbps=(double)sent*S/t_enc/1e3;
+  row.dec_mbps=(double)K*S/t_dec/1e3;
+  return row;
+}
+
+// Una riga JSON per linea: il baseline si rilegge senza un parser JSON completo
+static string suite_json(const SuiteRow& r){
+  ostringstream o; o << fixed << setprecision(4);
+  o << "{\"dec\":\"" << r.dec << "\",\"K\":" << r.K << ",\"S\":" << r.S << ",\"loss\":" << r.loss
+    << ",\"enc_mbps\":" << r.enc_mbps << ",\"dec_mbps\":" << r.dec_mbps << ",\"overhead\":" << r.overhead
+    << ",\"peak_kb\":" << r.peak_kb << ",\"allocs_per_sym\":" << r.allocs_per_sym << ",\"ok\":" << (r.ok ? "true" : "false") << "}";
+  return o.str();
+}
+
+static string json_field(const string& line, const string& key){
+  size_t p=line.find("\""+key+"\":"); if(p==string::npos) return "";
+  p+=key.size()+3; if(line[p]=='"'){ size_t e=line.find('"', p+1); return line.substr(p+1, e-p-1); }
+  size_t e=line.find_first_of(",}", p); return line.substr(p, e-p);
+}
+
+static vector<SuiteRow> suite_load(const string& path){
+  vector<SuiteRow> rows; ifstream in(path); string line;
+  while(getline(in, line)){
+    if(line.find("\"dec\":")==string::npos) continue;
+    SuiteRow r; r.dec=json_field(line, "dec"); r.K=atoi(json_field(line, "K").c_str()); r.S=(size_t)atoll(json_field(line, "S").c_str());
+    r.loss=atof(json_field(line, "loss").c_str()); r.enc_mbps=atof(json_field(line, "enc_mbps").c_str());
+    r.dec_mbps=atof(json_field(line, "dec_mbps").c_str()); r.overhead=atof(json_field(line, "overhead").c_str());
+    r.peak_kb=atof(json_field(line, "peak_kb").c_str()); r.allocs_per_sym=atof(json_field(line, "allocs_per_sym").c_str());
+    r.ok=json_field(line, "ok")=="true"; rows.push_back(r);
+  }
+  return rows;
+}
+
+// Regressione: overhead o picco di heap oltre (1 + tol) del baseline, allocazioni per simbolo
+// in crescita, decodifica fallita. Sono le colonne deterministiche (semi fissati); il throughput
+// dipende dalla macchina e dal carico e si controlla solo con tput_tol >= 0 (--tput-tol):
+// encode o decode sotto (1 - tput_tol) del baseline
+static int suite_compare(const vector<SuiteRow>& rows, const vector<SuiteRow>& base, double tol, double tput_tol){
+  auto key=[](const SuiteRow& r){ return make_tuple(r.dec, r.K, r.S, (int)lround(r.loss*1000)); };
+  map<decltype(key(rows[0])), const SuiteRow*> idx; for(const auto& b:base) idx[key(b)]=&b;
+  int regressions=0, matched=0;
+  cout << fixed << setprecision(2) << "[BENCH][SUITE] confronto con il baseline (tol=" << tol;
+  if(tput_tol>=0) cout << ", tput_tol=" << tput_tol; else cout << ", throughput non controllato";
+  cout << ")\n";
+  for(const auto& r:rows){
+    auto it=idx.find(key(r)); if(it==idx.end()) continue; const SuiteRow& b=*it->second; ++matched;
+    vector<string> why;
+    if(tput_tol>=0 && r.enc_mbps<b.enc_mbps*(1-tput_tol)) why.push_back("enc");
+    if(tput_tol>=0 && r.dec_mbps<b.dec_mbps*(1-tput_tol)) why.push_back("dec");
+    if(r.overhead>b.overhead*(1+tol)) why.push_back("overhead");
+    if(r.peak_kb>b.peak_kb*(1+tol)+1.0) why.push_back("peak");
+    if(r.allocs_per_sym>b.allocs_per_sym+0.01) why.push_back("allocs");
+    if(b.ok && !r.ok) why.push_back("FAIL");
+    if(why.empty()) continue;
+    ++regressions;
+    cout << "  " << left << setw(7) << r.dec << "K=" << setw(6) << r.K << "S=" << setw(6) << r.S << "loss=" << setw(6) << r.loss << setprecision(1)
+         << " dec " << b.dec_mbps << " -> " << r.dec_mbps << " MB/s, enc " << b.enc_mbps << " -> " << r.enc_mbps << " MB/s, overhead "
+         << setprecision(3) << b.overhead << " -> " << r.overhead << ", peak " << setprecision(1) << b.peak_kb << " -> " << r.peak_kb
+         << " KB, allocs/sym " << setprecision(2) << b.allocs_per_sym << " -> " << r.allocs_per_sym << " [";
+    for(size_t i=0;i<why.size();++i) cout << (i ? "," : "") << why[i];
+    cout << "]\n";
+  }
+  cout << "  righe confrontate=" << matched << " regressioni=" << regressions << "\n";
+  return regressions ? 1 : 0;
+}
+
+static vector<double> parse_list(const string& s){
+  vector<double> v; stringstream ss(s); string x; while(getline(ss, x, ',')) if(!x.empty()) v.push_back(atof(x.c_str())); return v;
+}
+static vector<string> parse_names(const string& s){
+  vector<string> v; stringstream ss(s); string x; while(getline(ss, x, ',')) if(!x.empty()) v.push_back(x); return v;
+}
+
+static int run_suite(int argc, char* argv[]){
+  vector<double> Ks{16, 64, 256, 1024}, Ss{64, 256, 1024}, losses{0.0, 0.1, 0.3};
+  vector<string> decs{"online", "dense", "peel", "mds"};
+  string json, csv, baseline; int reps=5; double tol=0.15, tput_tol=-1;
+  for(int i=2;i+1<argc;i+=2){
+    string a=argv[i], v=argv[i+1];
+    if(a=="--K") Ks=parse_list(v); else if(a=="--S") Ss=parse_list(v); else if(a=="--loss") losses=parse_list(v);
+    else if(a=="--dec") decs=parse_names(v); else if(a=="--reps") reps=atoi(v.c_str()); else if(a=="--json") json=v;
+    else if(a=="--csv") csv=v; else if(a=="--baseline") baseline=v; else if(a=="--tol") tol=atof(v.c_str());
+    else if(a=="--tput-tol") tput_tol=atof(v.c_str());
+    else { cerr << "suite: opzione sconosciuta " << a << "\n"; return 2; }
+  }
+  cout << "[BENCH][SUITE] reps=" << reps << " (MB/s di payload in decode, di simboli emessi in encode)\n";
+  cout << left << setw(8) << "dec" << setw(7) << "K" << setw(7) << "S" << setw(7) << "loss" << setw(11) << "enc_MB/s"
+       << setw(11) << "dec_MB/s" << setw(10) << "overhead" << setw(10) << "peak_KB" << "allocs/sym" << "\n";
+  cout << fixed;
+  vector<SuiteRow> rows; bool fail=false;
+  for(const auto& dec:decs) for(double K:Ks) for(double S:Ss) for(double loss:losses){
+    if(dec=="mds" && !fec::mds_fits((int)K)) continue;
+    if(dec!="online" && dec!="dense" && dec!="peel" && dec!="mds"){ cerr << "suite: decoder sconosciuto " << dec << "\n"; return 2; }
+    SuiteRow r=suite_case(dec, (int)K, (size_t)S, loss, reps); rows.push_back(r); fail|=!r.ok;
+    cout << left << setw(8) << r.dec << setw(7) << r.K << setw(7) << r.S << setw(7) << setprecision(2) << r.loss << setprecision(1)
+         << setw(11) << r.enc_mbps << setw(11) << r.dec_mbps << setprecision(3) << setw(10) << r.overhead << setprecision(1)
+         << setw(10) << r.peak_kb << setprecision(2) << r.allocs_per_sym << (r.ok ? "" : "  [FAIL]") << "\n";
+  }
+  if(!json.empty()){
+    ofstream o(json); o << "{\"bench\":\"aurora_fec_bench suite\",\"rows\":[\n";
+    for(size_t i=0;i<rows.size();++i) o << suite_json(rows[i]) << (i+1<rows.size() ? ",\n" : "\n");
+    o << "]}\n";
+  }
+  if(!csv.empty()){
+    ofstream o(csv); o << "dec,K,S,loss,enc_mbps,dec_mbps,overhead,peak_kb,allocs_per_sym,ok\n" << fixed << setprecision(4);
+    for(const auto& r:rows) o << r.dec << "," << r.K << "," << r.S << "," << r.loss << "," << r.enc_mbps << "," << r.dec_mbps << ","
+                              << r.overhead << "," << r.peak_kb << "," << r.allocs_per_sym << "," << (r.ok ? 1 : 0) << "\n";
+  }
+  if(!baseline.empty()){
+    auto base=suite_load(baseline);
+    if(base.empty()){ cerr << "suite: baseline vuoto o illeggibile: " << baseline << "\n"; return 2; }
+    if(suite_compare(rows, base, tol, tput_tol)) return 1;
+  }
+  return fail ? 1 : 0;
+}
+
+} // namespace bench
+
+int main(int argc, char* argv[]){
+  std::string mode = argc>1 ? argv[1] : "solve";
+  if(mode=="solve"){
+    size_t S = argc>2 ? (size_t)std::atoi(argv[2]) : 128;
+    int max_legacy_K = argc>3 ? std::atoi(argv[3]) : 1024;
+    return bench::run_solve(S, max_legacy_K);
+  }
+  if(mode=="peel"){
+    size_t S = argc>2 ? (size_t)std::atoi(argv[2]) : 128;
+    return bench::run_peel(S);
+  }
+  if(mode=="xor"){
+    size_t S = argc>2 ? (size_t)std::atoi(argv[2]) : 0;
+    return bench::run_xor(S);
+  }
+  if(mode=="fixed"){
+    int K = argc>2 ? std::atoi(argv[2]) : 256;
+    return bench::run_fixed(K);
+  }
+  if(mode=="emit"){
+    size_t S = argc>2 ? (size_t)std::atoi(argv[2]) : 128;
+    return bench::run_emit(S);
+  }
+  if(mode=="degree"){
+    size_t S = argc>2 ? (size_t)std::atoi(argv[2]) : 128;
+    int trials = argc>3 ? std::atoi(argv[3]) : 50;
+    return bench::run_degree(S, trials);
+  }
+  if(mode=="sys"){
+    size_t S = argc>2 ? (size_t)std::atoi(argv[2]) : 128;
+    return bench::run_sys(S);
+  }
+  if(mode=="alloc"){
+    size_t S = argc>2 ? (size_t)std::atoi(argv[2]) : 128;
+    return bench::run_alloc(S);
+  }
+  if(mode=="batch"){
+    size_t S = argc>2 ? (size_t)std::atoi(argv[2]) : 128;
+    return bench::run_batch(S);
+  }
+  if(mode=="blocks"){
+    size_t S = argc>2 ? (size_t)std::atoi(argv[2]) : 1024;
+    return bench::run_blocks(S);
+  }
+  if(mode=="sw"){
+    size_t S = argc>2 ? (size_t)std::atoi(argv[2]) : 64;
+    return bench::run_sw(S);
+  }
+  if(mode=="mds"){
+    size_t S = argc>2 ? (size_t)std::atoi(argv[2]) : 128;
+    int trials = argc>3 ? std::atoi(argv[3]) : 1000;
+    return bench::run_mds(S, trials);
+  }
+#ifdef AURORA_USE_RAPTORQ
+  if(mode=="rq"){
+    size_t S = argc>2 ? (size_t)std::atoi(argv[2]) : 128;
+    int trials = argc>3 ? std::atoi(argv[3]) : 20;
+    return bench::run_rq(S, trials);
+  }
+#endif
+  if(mode=="suite") return bench::run_suite(argc, argv);
+  std::cerr << "uso: aurora_fec_bench solve [S] [max_legacy_K] | peel [S] | xor [S] | emit [S] | degree [S] [trials] | sys [S] | alloc [S] | batch [S] | blocks [S] | sw [S] | mds [S] [trials] | rq [S] [trials] | suite [--opzione valore ...]\n";
+  return 2;
+}
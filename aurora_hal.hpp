@@ -18,14 +18,28 @@
 #include <deque>
 #include <random>
 #include <chrono>
+#include <atomic>
+#include <thread>
+#include "src/fec/AuroraTokenHandle.hpp"
 using namespace std;
 using namespace chrono;
 
 namespace util {
   struct RNG{ uint64_t s; explicit RNG(uint64_t x=0xC0FFEEBEEFULL):s(x){} inline uint64_t next(){ s^=s<<7; s^=s>>9; s^=s<<8; return s; } inline double uni(){ return (next()>>11) * (1.0/((1ull<<53)-1)); } };
-  static inline RNG rng;
+  // Stato per thread: il thread principale parte dal seme fisso (riproducibile come prima), ogni
+  // altro thread da un seme suo, cosi' spawn concorrenti e Token::make non ripetono le sequenze
+  static inline const thread::id main_thread=this_thread::get_id();
+  static inline uint64_t thread_seed(){
+    static atomic<uint64_t> next_thread{0};
+    if(this_thread::get_id()==main_thread) return 0xC0FFEEBEEFULL;
+    uint64_t z=0xC0FFEEBEEFULL+(next_thread.fetch_add(1)+1)*0x9E3779B97F4A7C15ULL;   // SplitMix64
+    z=(z^(z>>30))*0xBF58476D1CE4E5B9ULL; z=(z^(z>>27))*0x94D049BB133111EBULL; z^=z>>31;
+    return z? z : 0xC0FFEEBEEFULL;   // xorshift: stato mai nullo
+  }
+  static inline thread_local RNG rng{thread_seed()};
   static inline uint64_t now_s(){ return (uint64_t)time(nullptr); }
-  static inline string h64(const string& s){ uint64_t z=0x9E3779B97F4A7C15ULL; for(unsigned char c:s){ z^=(uint64_t)c+0x9e3779b97f4a7c15ULL+(z<<6)+(z>>2);} z^=z<<13; z^=z>>7; z^=z<<17; stringstream ss; ss<<hex<<setw(16)<<setfill('0')<<z; return ss.str(); }
+  // 16 cifre esadecimali di fec::token_digest (gli id dei Token: fec::token_handle li riporta a intero)
+  static inline string h64(const string& s){ stringstream ss; ss<<hex<<setw(16)<<setfill('0')<<fec::token_digest(s); return ss.str(); }
 }
 
 namespace HAL {
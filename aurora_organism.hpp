@@ -1,26 +1,35 @@
 #pragma once
 
+// -DAURORA_EMBEDDED: al posto dell'organismo completo, la configurazione MCU a capacita'
+// fissa e senza heap (aurora::EmbeddedOrganism, src/core/AuroraEmbeddedOrganism.hpp)
+#ifdef AURORA_EMBEDDED
+#include "src/core/AuroraEmbeddedOrganism.hpp"
+#else
+
 #include <vector>
 #include <string>
 #include <cstdint>
 #include <memory>
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
 #include <unordered_map>
+#include <deque>
+#include <functional>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 #include "aurora_intention.hpp"
 #include "aurora_extreme.hpp"
+#include "src/core/AuroraFlowClass.hpp"
 
 namespace aurora {
 
-// Classificazione biologica del flusso: tipo di tessuto di trasporto
-enum class FlowClass : uint8_t {
-    NERVE,   // latenza critica, payload piccolo, alta priorità
-    MUSCLE,  // bulk data, throughput importante, può tollerare ritardi
-    GLAND    // eventi rari, altissima affidabilità, meno sensibili alla latenza
-};
-
 // FASE 5b: Genotipo - strategia adattiva dell'organismo
 enum class Genotype {
     BASELINE,        // comportamento attuale
@@ -43,23 +52,66 @@ struct FlowProfile {
     double deadline_s;    // tempo massimo utile
     double reliability;   // 0..1
     double duty_limit;    // massimo duty RF/IR
-    std::string priority; // "CRITICAL", "NORMAL", "BULK", ecc.
+    Priority priority = Priority::NORMAL;      // da reliability (build_profile)
     FlowClass flow_class = FlowClass::MUSCLE;  // classificazione biologica
     GenotypeHint genotype_hint = GenotypeHint::AUTO;  // FASE 5b: hint per selezione genotipo
 };
 
+inline std::ostream& operator<<(std::ostream& os, Priority p) { return os << priority_name(p); }
+inline std::ostream& operator<<(std::ostream& os, FlowClass c) { return os << flow_class_name(c); }
+
 struct OrganismSpawnResult {
     std::vector<fec::Pkt> packets;   // simboli da seminare nella rete
+    // Byte dei simboli: i Pkt in packets (e le loro copie) sono viste in queste slab,
+    // valide finche' vive questo risultato
+    std::vector<fec::SymbolSlab> slabs;
     int K;                           // numero blocchi logici minimi
     std::size_t payload_size;        // dimensione totale payload in byte
 };
 
+// Protezione disuguale a strati (spawn_layered): il chiamante dichiara intervalli di byte del
+// payload con un livello di importanza (0 = massima, fino a LAYER_LEVELS - 1). Ogni livello ha
+// il suo overhead adattivo in FlowState; i byte non dichiarati vanno in strati impliciti
+// di importanza minima
+constexpr size_t LAYER_LEVELS = 4;
+constexpr size_t MAX_LAYERS = 255;   // Pkt::layer e' un uint8_t
+
+struct PayloadLayer {
+    size_t offset = 0;
+    size_t length = 0;
+    uint8_t importance = 0;
+    
+    bool operator==(const PayloadLayer&) const = default;
+};
+
+// Strato ricostruito, rilasciato dalla integrate() in cui si completa
+struct LayerDelivery {
+    size_t offset = 0;
+    uint8_t importance = 0;
+    std::vector<uint8_t> bytes;
+};
+
+// Segmento ricostruito, notificato appena decodifica (AlienFountainOrganism::set_delivery_callback):
+// il critico intero, un blocco sorgente del bulk o uno strato UEP, senza aspettare il resto del
+// token. offset/length nel payload originale (il critico senza padding); data vale solo durante
+// la callback
+struct SegmentDelivery {
+    fec::TokenHandle token = 0;
+    fec::SegmentKind kind = fec::SegmentKind::CRITICAL;
+    uint32_t index = 0;            // blocco del bulk o strato (0 per il critico)
+    size_t offset = 0;
+    size_t length = 0;
+    const uint8_t* data = nullptr;
+};
+using DeliveryCallback = std::function<void(const SegmentDelivery&)>;
+
 struct OrganismIntegrateResult {
     bool delivered = false;                  // true se ricostruzione riuscita completa
-    double coverage = 0.0;                   // 0..1, frazione di payload ricostruito in modo affidabile
+    double coverage = 0.0;                   // 0..1, frazione di byte del payload gia' ricostruiti (anche sparsi)
     int symbols_used = 0;                    // numero simboli effettivamente usati per decode
     int total_symbols_seen = 0;              // numero totale simboli ricevuti per token_id
-    std::vector<uint8_t> payload_bytes;      // payload ricostruito (parziale o completo)
+    std::vector<uint8_t> payload_bytes;      // payload completo, o il prefisso contiguo gia' ricostruito
+    std::vector<LayerDelivery> layers;       // token a strati: strati completati in questa chiamata
 };
 
 // Interfaccia base per l'organismo di trasporto
@@ -71,14 +123,29 @@ public:
     virtual FlowProfile build_profile(const Intention& I) const = 0;
 
     // Genera i simboli da seminare in rete a partire dal Token serializzato
+    // (symbol_size = 0: scelta di symbol_size_for; la dimensione viaggia in ogni Pkt)
     virtual OrganismSpawnResult spawn(
         const FlowProfile& profile,
         const std::string& token_id,
         const std::vector<uint8_t>& payload_bytes,
-        size_t symbol_size = 128
+        size_t symbol_size = 0
     ) = 0;
 
+    // Byte per simbolo per un payload di questo flusso, data la perdita attesa per pacchetto
+    virtual size_t symbol_size_for(const FlowProfile& profile, size_t payload_size, double expected_loss = 0.1) {
+        (void)profile; (void)payload_size; (void)expected_loss;
+        return 128;
+    }
+
+    // Flussi che usano il canale di ritorno (se c'e'): il ricevitore riassume i sorgenti
+    // mancanti (fec::Hint) e il mittente orienta i repair successivi su quelli
+    virtual bool wants_feedback(const FlowProfile& profile) const {
+        (void)profile;
+        return false;
+    }
+
     // Tenta di integrare i simboli arrivati per un token e ricostruire il payload
+    // (symbol_size vale solo se i Pkt non portano la loro dimensione)
     virtual OrganismIntegrateResult integrate(
         const FlowProfile& profile,
         const std::string& token_id,
@@ -117,19 +184,157 @@ struct FlowState {
     Genotype genotype = Genotype::BASELINE;
     bool initialized = false;
     int age = 0;  // opzionale, per futuri usi/evoluzione
+    
+    // Strati UEP: overhead per livello di importanza, dal critico (0) al bulk (LAYER_LEVELS - 1)
+    std::array<double, LAYER_LEVELS> layer_overhead{};
+    std::array<double, LAYER_LEVELS> base_layer_overhead{};
 };
 
-// Implementazione ALIENA avanzata: organo biologico con segmentazione e memoria immunitaria
+// Stati adattivi indicizzati per (FlowClass, Priority): tabella piatta, una voce per linea di
+// cache, niente chiavi stringa ne' hash su spawn/integrate. SHARDED = true aggiunge un mutex
+// per voce: thread su flussi diversi non si contendono nulla, lo stesso flusso si serializza
+// solo sulla sua voce
+template<bool SHARDED>
+class FlowStateTable {
+public:
+    static constexpr size_t SIZE = FLOW_CLASS_COUNT * PRIORITY_COUNT;
+    
+    static constexpr size_t index(FlowClass cls, Priority prio) {
+        return static_cast<size_t>(cls) * PRIORITY_COUNT + static_cast<size_t>(prio);
+    }
+    
+    // f(FlowState&) sulla voce del flusso (sotto il suo lock se SHARDED), ritorna cio' che ritorna f
+    template<typename F>
+    decltype(auto) with(FlowClass cls, Priority prio, F&& f) {
+        Slot& slot = slots_[index(cls, prio)];
+        std::lock_guard<Lock> lk(slot.mu);
+        return f(slot.st);
+    }
+    
+    // Copia coerente della voce
+    FlowState get(FlowClass cls, Priority prio) const {
+        const Slot& slot = slots_[index(cls, prio)];
+        std::lock_guard<Lock> lk(slot.mu);
+        return slot.st;
+    }
+    
+private:
+    struct NoLock {
+        void lock() {}
+        void unlock() {}
+    };
+    using Lock = std::conditional_t<SHARDED, std::mutex, NoLock>;
+    struct alignas(64) Slot {
+        FlowState st;
+        mutable Lock mu;
+    };
+    std::array<Slot, SIZE> slots_{};
+};
+
+using ShardedFlowStateTable = FlowStateTable<true>;
+
+// Implementazione ALIENA avanzata: organo biologico con segmentazione e memoria immunitaria.
+// spawn/integrate si possono chiamare da piu' thread insieme (stati di flusso e contesti dei
+// token hanno lock per voce/shard, nessun lock globale); lo streaming NERVE resta a thread singolo
 class AlienFountainOrganism : public AuroraOrganism {
 private:
-    // Stato interno per ricordare K critico e bulk (utile per integrate)
-    int _K_critical = 0;
-    int _K_bulk = 0;
-    size_t _critical_size = 0;
-    size_t _bulk_size = 0;
+    // Memoria immunitaria: stato adattivo per (classe, priorita') del flusso
+    ShardedFlowStateTable flow_states_;
+    // Dimagrimento: almeno 4 successi "calmi" di fila (update_flow_state, update_layer_overheads)
+    static constexpr int GOOD_STREAK_THRESHOLD = 4;
+    
+    // Decoder persistenti per token: eliminazione incrementale tra una integrate() e l'altra
+    struct TokenDecoders {
+        int K_crit = 0;
+        int K_bulk = 0;
+        size_t symbol_size = 0;
+        fec::AnyDecoder crit;
+        fec::BlockedDecoder bulk;   // un decoder per blocco sorgente del bulk
+        size_t fed = 0;         // pacchetti di received_packets gia' consumati
+        int seen = 0;           // pacchetti visti per questo token
+        int used_crit = 0;
+        int used_bulk = 0;
+        bool crit_ok = false;
+        bool bulk_ok = false;
+        bool crit_fresh = false;       // simboli critici nuovi dall'ultimo recupero parziale
+        fec::PartialSolve part_crit;   // sorgenti critici gia' determinati (prima del rango pieno)
+        std::vector<uint8_t> bytes_crit;
+        std::vector<uint8_t> bytes_bulk;
+        
+        TokenDecoders(int kc, int kb, size_t S, const fec::BlockLayout& bulk_layout)
+            : K_crit(kc), K_bulk(kb), symbol_size(S),
+              crit(fec::mds_fits(kc) ? fec::DecoderKind::MDS : fec::DecoderKind::DENSE, std::max(kc, 0), S),
+              bulk(bulk_layout) {}
+    };
+    
+    // Decoder di un token a strati: un BlockedDecoder per strato, ognuno si completa per conto suo
+    // (blocchi piccoli in MDS, come il critico)
+    struct LayerDecoders {
+        size_t symbol_size = 0;
+        std::vector<fec::BlockedDecoder> dec;
+        std::vector<uint8_t> released;   // strato gia' consegnato in una integrate() precedente
+        size_t fed = 0;
+        int seen = 0;
+        int used = 0;
+        
+        LayerDecoders(const std::vector<PayloadLayer>& layers, size_t S)
+            : symbol_size(S), released(layers.size(), 0) {
+            dec.reserve(layers.size());
+            for (const auto& L : layers) dec.emplace_back(fec::block_layout(L.length, S), true);
+        }
+    };
+    
+    // Contesto per token: geometria dei segmenti fissata dallo spawn, decoder e contatori di
+    // arrivo. Piu' token in volo insieme, ognuno con la sua geometria; un token mai spawnato
+    // qui (altro mittente) stima K da K_hint. Scade dopo token_ttl_ chiamate spawn/integrate
+    // senza uso, e oltre max_tokens_ contesti (in tutta la tabella) si libera quello usato meno
+    // di recente
+    struct TokenContext {
+        int K_crit = 0;
+        int K_bulk = 0;
+        size_t critical_size = 0;
+        size_t bulk_size = 0;
+        bool spawned = false;                  // geometria esatta (spawn su questo organismo)
+        uint64_t last_use = 0;                 // tick dell'ultimo spawn/integrate
+        std::unique_ptr<TokenDecoders> rx;     // creati alla prima integrate()
+        std::vector<PayloadLayer> layers;      // geometria a strati (layer_geometry), vuota = critico/bulk
+        std::unique_ptr<LayerDecoders> layer_rx;
+        // Segmenti gia' notificati (critico = 0, blocco b del bulk = 1 + b; strato l = l):
+        // sopravvive al reset dei decoder dopo la consegna, si azzera quando cambia la geometria
+        std::vector<uint8_t> notified;
+        // Gia' consegnato: una integrate() successiva ridecodifica ma non conta un altro
+        // successo in FlowState. Si azzera con notified
+        bool delivered = false;
+    };
+    DeliveryCallback on_delivery_;
+    static constexpr size_t MAX_TOKENS = 1024;
+    static constexpr uint64_t TOKEN_TTL = 4096;
+    // Contesti divisi in shard per handle, ognuno col suo lock (tenuto da integrate() per tutta
+    // la decodifica del token); tick globale. max_tokens_ vale per tutta la tabella:
+    // token_count_ conta i contesti di tutti gli shard (aggiornato sotto il lock dello shard)
+    static constexpr size_t TOKEN_SHARDS = 16;
+    struct alignas(64) TokenShard {
+        mutable std::mutex mu;
+        std::unordered_map<fec::TokenHandle, TokenContext> map;
+    };
+    struct LockedContext {
+        std::unique_lock<std::mutex> lock;
+        TokenContext& ctx;
+    };
+    std::array<TokenShard, TOKEN_SHARDS> token_shards_;
+    std::atomic<size_t> max_tokens_{MAX_TOKENS};
+    std::atomic<size_t> token_count_{0};
+    std::atomic<uint64_t> token_ttl_{TOKEN_TTL};
+    std::atomic<uint64_t> tick_{0};
     
-    // Memoria immunitaria: stato adattivo per ogni tipo di flusso
-    std::unordered_map<std::string, FlowState> flow_states_;
+    // Modo streaming (NERVE): un codec a finestra scorrevole per stream, lato tx e rx
+    static constexpr uint32_t STREAM_WINDOW = 32;
+    struct StreamTx {
+        fec::SlidingWindowEncoder enc;
+        double repair_credit = 0.0;   // frazione di repair maturata e non ancora emessa
+    };
+    std::unordered_map<std::string, StreamTx> stream_tx_;
+    std::unordered_map<std::string, fec::SlidingWindowDecoder> stream_rx_;
     
     // FASE 5b: Helper per selezione genotipo
     static Genotype choose_initial_genotype(const FlowProfile& profile) {
@@ -206,18 +411,13 @@ private:
         return gp;
     }
     
-    // Helper: costruisce chiave univoca per tipo di flusso
-    static std::string make_flow_key(const FlowProfile& profile) {
-        std::string cls;
-        switch (profile.flow_class) {
-            case FlowClass::NERVE:  cls = "NERVE"; break;
-            case FlowClass::GLAND:  cls = "GLAND"; break;
-            case FlowClass::MUSCLE: cls = "MUSCLE"; break;
-        }
-        return cls + ":" + profile.priority;
+public:
+    // La calibrazione di fec::DecodeCost (microbenchmark di pochi ms, una volta per processo)
+    // avviene qui e non alla prima symbol_size_for(), dentro spawn() sotto il lock del token
+    AlienFountainOrganism() {
+        fec::DecodeCost::shared();
     }
     
-public:
     FlowProfile build_profile(const Intention& I) const override {
         FlowProfile profile;
         profile.deadline_s = I.deadline_s;
@@ -226,11 +426,11 @@ public:
         
         // Mappa reliability a priority
         if (profile.reliability >= 0.99) {
-            profile.priority = "CRITICAL";
+            profile.priority = Priority::CRITICAL;
         } else if (profile.reliability >= 0.90) {
-            profile.priority = "NORMAL";
+            profile.priority = Priority::NORMAL;
         } else {
-            profile.priority = "BULK";
+            profile.priority = Priority::BULK;
         }
         
         // Classificazione biologica basata su deadline, reliability e payload atteso
@@ -250,16 +450,18 @@ public:
         return profile;
     }
     
-    // Helper: calcola overhead per parte critica in base a FlowClass
+    // Helper: calcola overhead per parte critica in base a FlowClass.
+    // Il critico (K <= fec::MDS_MAX_K) usa il codice MDS: qualsiasi K simboli bastano, la
+    // ridondanza copre solo le perdite e non piu' l'overhead di ricezione LT a K piccolo
     static double crit_overhead_factor(const FlowProfile& p) {
         switch (p.flow_class) {
             case FlowClass::NERVE:
-                return 3.0;  // massima ridondanza per latenza critica
+                return 2.0;  // massima ridondanza per latenza critica
             case FlowClass::GLAND:
-                return 2.5;  // alta ridondanza per affidabilità estrema
+                return 2.0;  // alta ridondanza per affidabilità estrema
             case FlowClass::MUSCLE:
             default:
-                return 1.5;  // overhead moderato per bulk
+                return 1.25; // overhead moderato per bulk
         }
     }
     
@@ -276,27 +478,33 @@ public:
         }
     }
     
-    // Helper: segmenta payload in critical e bulk
-    PayloadSegments segment_payload(
-        const std::vector<uint8_t>& payload_bytes,
-        const FlowProfile& profile
-    ) const {
-        PayloadSegments segments;
-        
-        // Determina dimensione parte critica in base a FlowClass
+    // Helper: byte della parte critica in base a FlowClass (tutto il payload se non si segmenta)
+    static size_t critical_size_for(const FlowProfile& profile, size_t payload_size) {
         size_t critical_size;
         switch (profile.flow_class) {
             case FlowClass::NERVE:
-                critical_size = std::min(static_cast<size_t>(256), payload_bytes.size());
+                critical_size = std::min(static_cast<size_t>(256), payload_size);
                 break;
             case FlowClass::GLAND:
-                critical_size = std::min(static_cast<size_t>(512), payload_bytes.size());
+                critical_size = std::min(static_cast<size_t>(512), payload_size);
                 break;
             case FlowClass::MUSCLE:
             default:
-                critical_size = std::min(static_cast<size_t>(128), payload_bytes.size());
+                critical_size = std::min(static_cast<size_t>(128), payload_size);
                 break;
         }
+        return (critical_size > 0 && critical_size < payload_size) ? critical_size : payload_size;
+    }
+    
+    // Helper: segmenta payload in critical e bulk
+    PayloadSegments segment_payload(
+        const std::vector<uint8_t>& payload_bytes,
+        const FlowProfile& profile
+    ) const {
+        PayloadSegments segments;
+        
+        // Determina dimensione parte critica in base a FlowClass
+        size_t critical_size = critical_size_for(profile, payload_bytes.size());
         
         // Estrai parte critica e bulk
         if (critical_size > 0 && critical_size < payload_bytes.size()) {
@@ -311,104 +519,167 @@ public:
         return segments;
     }
 
+    // Autotuning della dimensione simbolo: candidati potenze di 2 (multipli di SUB_ALIGN),
+    // il limite superiore sta nel campo Pkt::sym
+    static constexpr size_t SYMBOL_SIZES[] = {32, 64, 128, 256, 512, 1024};
+    static constexpr size_t WIRE_HEADER = 8;        // byte di header per pacchetto (come Node::send_one)
+    static constexpr size_t LOSS_REF_SYMBOL = 128;  // expected_loss e' riferita a frame di 128 + header
+    static constexpr double RF_TX_W = 0.1;          // potenza di trasmissione: tempo in aria = Jpkt / RF_TX_W
+    static constexpr double RX_CPU_W = 0.5;         // potenza della CPU del ricevitore durante la decodifica
+    
+    // Costo atteso di un payload con simboli da S byte. Per segmento si inviano
+    // n = max(ceil(K * overhead), K * need / (1 - p)) pacchetti: need e' l'overhead di ricezione
+    // (1 per MDS, ~1 + 2/sqrt(K) per LT), p la perdita per pacchetto, che cresce con la
+    // lunghezza del frame. NERVE minimizza la latenza (tempo in aria + decodifica), GLAND e
+    // MUSCLE l'energia (radio + CPU del ricevitore, decodifica da fec::DecodeCost calibrato).
+    double symbol_size_cost(const FlowProfile& profile, size_t payload_size, size_t S, double expected_loss) {
+        const FlowState st = flow_state(profile);
+        const fec::DecodeCost& cpu = fec::DecodeCost::shared();
+        const double loss = std::clamp(expected_loss, 0.0, 0.95);
+        const double p = 1.0 - std::pow(1.0 - loss, double(S + WIRE_HEADER) / double(LOSS_REF_SYMBOL + WIRE_HEADER));
+        auto segment = [&](size_t bytes, double ov, bool critical) {
+            if (bytes == 0) return 0.0;
+            const double K = std::ceil(double(bytes) / double(S));
+            const double need = (critical && fec::mds_fits(static_cast<int>(K))) ? 1.0 : 1.0 + 2.0 / std::sqrt(K);
+            const double n = std::max(std::ceil(K * ov), K * need / std::max(1e-3, 1.0 - p));
+            const double air_J = n * phy::Jpkt(phy::Mode::RF, S + WIRE_HEADER);
+            const double decode_s = cpu.payload_ms(bytes, S) / 1000.0;
+            return profile.flow_class == FlowClass::NERVE ? air_J / RF_TX_W + decode_s : air_J + RX_CPU_W * decode_s;
+        };
+        const size_t crit = critical_size_for(profile, payload_size);
+        return segment(crit, st.crit_overhead, true) + segment(payload_size - crit, st.bulk_overhead, false);
+    }
+    
+    size_t symbol_size_for(const FlowProfile& profile, size_t payload_size, double expected_loss = 0.1) override {
+        size_t best = SYMBOL_SIZES[0];
+        double best_cost = INFINITY;
+        for (size_t S : SYMBOL_SIZES) {
+            double c = symbol_size_cost(profile, payload_size, S, expected_loss);
+            if (c < best_cost) { best_cost = c; best = S; }
+        }
+        return best;
+    }
+    
+    // GLAND: payload grandi e affidabilita' estrema, la coda della decodifica pesa di piu'
+    bool wants_feedback(const FlowProfile& profile) const override {
+        return profile.flow_class == FlowClass::GLAND;
+    }
+    
     OrganismSpawnResult spawn(
         const FlowProfile& profile,
         const std::string& token_id,
         const std::vector<uint8_t>& payload_bytes,
-        size_t symbol_size = 128
+        size_t symbol_size = 0
     ) override {
         OrganismSpawnResult result;
         result.payload_size = payload_bytes.size();
         
-        // Recupera/initializza stato adattivo per questo tipo di flusso
-        auto key = make_flow_key(profile);
-        auto& st = flow_states_[key];
-        
-        // FASE 5b: Inizializza genotipo se non ancora fatto
-        if (!st.initialized) {
-            st.genotype = from_hint(profile.genotype_hint, profile);
-            st.initialized = true;
-            st.age = 0;
-            
-            // Log una tantum quando il genotipo viene inizializzato
-            std::string cls_name;
-            switch (profile.flow_class) {
-                case FlowClass::NERVE:  cls_name = "NERVE"; break;
-                case FlowClass::GLAND:  cls_name = "GLAND"; break;
-                case FlowClass::MUSCLE: cls_name = "MUSCLE"; break;
+        // Stato adattivo del flusso: overhead effettivi per QUESTO spawn, includendo panic_boost
+        double crit_ov = 1.0;
+        double bulk_ov = 1.0;
+        flow_states_.with(profile.flow_class, profile.priority, [&](FlowState& st) {
+            init_flow_state(profile, st);
+            st.age++;  // Incrementa età del genotipo
+            crit_ov = st.crit_overhead;
+            bulk_ov = st.bulk_overhead;
+            if (st.panic_boost > 0) {
+                // "Rilascio di citochine" – risposta acuta
+                crit_ov *= 2.0;   // super-ridondanza sulla parte critica
+                bulk_ov *= 1.5;   // leggera inflazione anche sul bulk
+                st.panic_boost -= 1;
             }
-            std::cout << "[ALIEN][GENO] class=" << cls_name
-                      << " genotype=" << genotype_to_string(st.genotype) << std::endl;
-        }
-        
-        // Prima volta: inizializza dai fattori statici esistenti
-        if (st.base_crit_overhead == 1.0 && st.base_bulk_overhead == 1.0 &&
-            st.success_count == 0 && st.fail_count == 0 && st.avg_coverage == 0.0) {
-            // Prima volta: inizializza dai fattori statici esistenti
-            st.base_crit_overhead = crit_overhead_factor(profile);
-            st.base_bulk_overhead = bulk_overhead_factor(profile);
-            st.crit_overhead = st.base_crit_overhead;
-            st.bulk_overhead = st.base_bulk_overhead;
-        }
-        
-        st.age++;  // Incrementa età del genotipo
+        });
+        if (symbol_size == 0) symbol_size = symbol_size_for(profile, payload_bytes.size());
         
         // Segmenta payload in critical e bulk
         PayloadSegments segments = segment_payload(payload_bytes, profile);
-        _critical_size = segments.critical.size();
-        _bulk_size = segments.bulk.size();
+        const fec::TokenHandle token = fec::token_handle(token_id);
         
-        // Usa due encoder separati per critical e bulk
+        // Usa encoder separati per critical e bulk
         // Usiamo lo stesso symbol_size per entrambi per semplicità
         fec::Encoder enc_crit(segments.critical, symbol_size);
-        fec::Encoder enc_bulk(segments.bulk, symbol_size);
+        // Bulk in blocchi sorgente da al piu' fec::BLOCK_MAX_K simboli, un encoder per blocco:
+        // il ricevitore decodifica ogni blocco per conto suo (e in parallelo)
+        fec::BlockLayout bulk_layout = fec::block_layout(segments.bulk.size(), symbol_size);
+        std::vector<fec::Encoder> enc_bulk;
+        if (!segments.bulk.empty()) {
+            enc_bulk.reserve(bulk_layout.Z);
+            for (uint32_t b = 0; b < bulk_layout.Z; ++b) {
+                enc_bulk.emplace_back(segments.bulk.data() + bulk_layout.offset(b), bulk_layout.bytes(b), symbol_size);
+            }
+        }
+        // Modo sistematico: i primi K simboli sono i blocchi in chiaro, su canale pulito
+        // il decoder li copia senza eliminazione; i simboli oltre K sono repair LT,
+        // o MDS GF(256) per il critico quando e' abbastanza piccolo
+        enc_crit.systematic = true;
+        enc_crit.mds = fec::mds_fits(enc_crit.N());
+        for (auto& enc : enc_bulk) enc.systematic = true;
         
-        _K_critical = segments.critical.empty() ? 0 : enc_crit.N();
-        _K_bulk = segments.bulk.empty() ? 0 : enc_bulk.N();
+        // Geometria del token per integrate(): un nuovo spawn con forma diversa azzera i decoder
+        const int K_crit = segments.critical.empty() ? 0 : enc_crit.N();
+        const int K_bulk = segments.bulk.empty() ? 0 : static_cast<int>(bulk_layout.Kt);
+        auto [lock, ctx] = token_context(token);
+        if (!ctx.layers.empty() ||
+            (ctx.spawned && (ctx.K_crit != K_crit || ctx.K_bulk != K_bulk ||
+                             ctx.critical_size != segments.critical.size() || ctx.bulk_size != segments.bulk.size()))) {
+            ctx.rx.reset();
+            ctx.notified.clear();
+            ctx.delivered = false;
+        }
+        ctx.K_crit = K_crit;
+        ctx.K_bulk = K_bulk;
+        ctx.critical_size = segments.critical.size();
+        ctx.bulk_size = segments.bulk.size();
+        ctx.spawned = true;
+        ctx.layers.clear();
+        ctx.layer_rx.reset();
+        lock.unlock();
         
         // K totale = somma dei K dei due encoder
-        result.K = _K_critical + _K_bulk;
-        
-        // Calcola overhead effettivi per QUESTO spawn, includendo panic_boost
-        double crit_ov = st.crit_overhead;
-        double bulk_ov = st.bulk_overhead;
-        
-        if (st.panic_boost > 0) {
-            // "Rilascio di citochine" – risposta acuta
-            crit_ov *= 2.0;   // super-ridondanza sulla parte critica
-            bulk_ov *= 1.5;   // leggera inflazione anche sul bulk
-            st.panic_boost -= 1;
-        }
+        result.K = K_crit + K_bulk;
         
         int num_sym_crit = 0;
         int num_sym_bulk = 0;
         
-        if (_K_critical > 0) {
-            num_sym_crit = static_cast<int>(std::ceil(_K_critical * crit_ov));
+        if (K_crit > 0) {
+            num_sym_crit = static_cast<int>(std::ceil(K_crit * crit_ov));
             // Sicurezza minima: almeno K simboli
-            if (num_sym_crit < _K_critical) num_sym_crit = _K_critical;
+            if (num_sym_crit < K_crit) num_sym_crit = K_crit;
         }
-        if (_K_bulk > 0) {
-            num_sym_bulk = static_cast<int>(std::ceil(_K_bulk * bulk_ov));
-            // Sicurezza minima: almeno K simboli
-            if (num_sym_bulk < _K_bulk) num_sym_bulk = _K_bulk;
+        // Overhead bulk applicato per blocco (almeno K simboli ciascuno)
+        std::vector<int> num_sym_block(enc_bulk.size(), 0);
+        for (size_t b = 0; b < enc_bulk.size(); ++b) {
+            int Kb = enc_bulk[b].N();
+            num_sym_block[b] = std::max(Kb, static_cast<int>(std::ceil(Kb * bulk_ov)));
+            num_sym_bulk += num_sym_block[b];
         }
         
-        // Pre-alloca spazio per tutti i pacchetti
-        result.packets.reserve(num_sym_crit + num_sym_bulk);
+        // Genera simboli critici e bulk in batch: la pianificazione (rng) resta sequenziale,
+        // le XOR dei repair di tutti i segmenti/blocchi vengono divise insieme sul pool di worker
+        std::vector<fec::Fp> fps(static_cast<size_t>(num_sym_crit + num_sym_bulk));
+        std::vector<fec::EmitBatch> batches;
+        batches.push_back({&enc_crit, static_cast<size_t>(num_sym_crit), fps.data()});
+        size_t at = static_cast<size_t>(num_sym_crit);
+        for (size_t b = 0; b < enc_bulk.size(); ++b) {
+            batches.push_back({&enc_bulk[b], static_cast<size_t>(num_sym_block[b]), fps.data() + at});
+            at += static_cast<size_t>(num_sym_block[b]);
+        }
+        fec::emit_batches(batches.data(), batches.size());
         
-        // Genera simboli critici
+        result.packets.reserve(fps.size());
         for (int i = 0; i < num_sym_crit; ++i) {
-            fec::Fp fp = enc_crit.emit();
-            result.packets.push_back({fp, 0, token_id, fec::SegmentKind::CRITICAL});
+            result.packets.push_back({fps[i], 0, token, fec::SegmentKind::CRITICAL, 0, static_cast<uint16_t>(symbol_size)});
         }
-        
-        // Genera simboli bulk
-        for (int i = 0; i < num_sym_bulk; ++i) {
-            fec::Fp fp = enc_bulk.emit();
-            result.packets.push_back({fp, 0, token_id, fec::SegmentKind::BULK});
+        at = static_cast<size_t>(num_sym_crit);
+        for (size_t b = 0; b < enc_bulk.size(); ++b) {
+            for (int i = 0; i < num_sym_block[b]; ++i) {
+                result.packets.push_back({fps[at++], 0, token, fec::SegmentKind::BULK, static_cast<uint32_t>(b),
+                                          static_cast<uint16_t>(symbol_size)});
+            }
         }
         
+        result.slabs.push_back(enc_crit.take_slab());
+        for (auto& enc : enc_bulk) result.slabs.push_back(enc.take_slab());
         return result;
     }
 
@@ -425,106 +696,144 @@ public:
         result.symbols_used = 0;
         result.total_symbols_seen = 0;
         
-        // Filtra received_packets per token_id
-        std::vector<fec::Pkt> filtered;
-        filtered.reserve(received_packets.size());
+        // La dimensione simbolo scelta dal mittente viaggia nei pacchetti
+        const fec::TokenHandle token = fec::token_handle(token_id);
         for (const auto& p : received_packets) {
-            if (p.token_id == token_id) {
-                filtered.push_back(p);
-            }
+            if (p.token == token && p.sym != 0) { symbol_size = p.sym; break; }
         }
+        if (symbol_size == 0) return result;
         
-        result.total_symbols_seen = static_cast<int>(filtered.size());
-        
-        if (filtered.empty()) {
-            return result;  // No packets for this token
+        // Geometria del token dal suo spawn, altrimenti stima da K_hint. Il lock dello shard
+        // resta preso fino alla fine della decodifica: lo stesso token non si integra in parallelo
+        auto [lock, ctx] = token_context(token);
+        if (!ctx.layers.empty()) {
+            return integrate_layers(profile, token, symbol_size, received_packets, lock, ctx);
         }
+        int K_crit = ctx.spawned ? ctx.K_crit : (K_hint / 2);
+        int K_bulk = ctx.spawned ? ctx.K_bulk : (K_hint - K_crit);
         
-        // Separare pacchetti critici vs bulk
-        std::vector<fec::Pkt> critical_packets;
-        std::vector<fec::Pkt> bulk_packets;
-        critical_packets.reserve(filtered.size());
-        bulk_packets.reserve(filtered.size());
+        // Stima dimensioni se non disponibili
+        size_t expected_critical_size = ctx.spawned ? ctx.critical_size : (K_crit * symbol_size);
+        size_t expected_bulk_size = ctx.spawned ? ctx.bulk_size : (K_bulk * symbol_size);
+        size_t expected_total_size = expected_critical_size + expected_bulk_size;
+        
+        // Decoder persistenti per questo token: si consumano solo i pacchetti nuovi
+        // (received_packets e' trattato come append-only; se cambia forma si riparte)
+        if (ctx.rx && (ctx.rx->K_crit != K_crit || ctx.rx->K_bulk != K_bulk || ctx.rx->symbol_size != symbol_size)) {
+            ctx.rx.reset();
+            ctx.notified.clear();
+            ctx.delivered = false;
+        }
+        if (ctx.rx && received_packets.size() < ctx.rx->fed) {
+            ctx.rx.reset();
+        }
+        if (!ctx.rx) {
+            // Stessa partizione in blocchi dello spawn; ogni blocco sceglie denso o peeling dal suo K
+            fec::BlockLayout bulk_layout = fec::block_layout(K_bulk > 0 ? expected_bulk_size : 0, symbol_size);
+            ctx.rx = std::make_unique<TokenDecoders>(K_crit, K_bulk, symbol_size, bulk_layout);
+        }
+        TokenDecoders& rx = *ctx.rx;
         
-        for (const auto& p : filtered) {
+        for (; rx.fed < received_packets.size(); ++rx.fed) {
+            const auto& p = received_packets[rx.fed];
+            if (p.token != token) continue;
+            rx.seen++;
             if (p.kind == fec::SegmentKind::CRITICAL) {
-                critical_packets.push_back(p);
-            } else {
-                bulk_packets.push_back(p);
+                if (K_crit > 0 && !rx.crit_ok && rx.crit.push(p.fp)) { rx.used_crit++; rx.crit_fresh = true; }
+            } else if (p.kind == fec::SegmentKind::BULK) {
+                if (K_bulk > 0 && !rx.bulk_ok && rx.bulk.push(p.block, p.fp)) rx.used_bulk++;
             }
         }
         
-        // Usa K critico e bulk se disponibili, altrimenti stima da K_hint
-        int K_crit = _K_critical > 0 ? _K_critical : (K_hint / 2);
-        int K_bulk = _K_bulk > 0 ? _K_bulk : (K_hint - K_crit);
+        result.total_symbols_seen = rx.seen;
         
-        // Stima dimensioni se non disponibili
-        size_t expected_critical_size = _critical_size > 0 ? _critical_size : (K_crit * symbol_size);
-        size_t expected_bulk_size = _bulk_size > 0 ? _bulk_size : (K_bulk * symbol_size);
-        size_t expected_total_size = expected_critical_size + expected_bulk_size;
+        if (rx.seen == 0) {
+            return result;  // No packets for this token
+        }
         
-        // Usa due decoder separati
-        bool crit_ok = false;
-        bool bulk_ok = false;
-        std::vector<uint8_t> bytes_crit;
-        std::vector<uint8_t> bytes_bulk;
-        int symbols_used_crit = 0;
-        int symbols_used_bulk = 0;
-        
-        // Decode parte critica
-        if (!critical_packets.empty() && K_crit > 0) {
-            fec::Decoder dec_crit(K_crit, symbol_size);
-            for (const auto& p : critical_packets) {
-                dec_crit.push(p.fp);
-                symbols_used_crit++;
-            }
-            auto [ok, bytes] = dec_crit.solve();
+        // Tenta il completamento solo quando il rango lo rende possibile
+        if (K_crit > 0 && !rx.crit_ok && rx.crit.ready()) {
+            auto [ok, bytes] = rx.crit.solve();
             if (ok && !bytes.empty()) {
-                crit_ok = true;
-                bytes_crit = std::move(bytes);
+                rx.crit_ok = true;
+                rx.bytes_crit = std::move(bytes);
+                // Notificato prima di decodificare il bulk: la latenza e' quella del solo critico
+                notify(ctx, 0, {token, fec::SegmentKind::CRITICAL, 0, 0,
+                                std::min(rx.bytes_crit.size(), expected_critical_size), rx.bytes_crit.data()});
             }
         }
-        
-        // Decode parte bulk
-        if (!bulk_packets.empty() && K_bulk > 0) {
-            fec::Decoder dec_bulk(K_bulk, symbol_size);
-            for (const auto& p : bulk_packets) {
-                dec_bulk.push(p.fp);
-                symbols_used_bulk++;
-            }
-            auto [ok, bytes] = dec_bulk.solve();
-            if (ok && !bytes.empty()) {
-                bulk_ok = true;
-                bytes_bulk = std::move(bytes);
+        if (K_bulk > 0 && !rx.bulk_ok) {
+            // blocchi pronti risolti in parallelo; il bulk e' completo quando lo sono tutti.
+            // Ogni blocco viene notificato dal worker che lo completa
+            const fec::BlockLayout& lay = rx.bulk.lay;
+            rx.bulk.solve_ready([&](uint32_t b) {
+                notify(ctx, 1 + b, {token, fec::SegmentKind::BULK, b, expected_critical_size + lay.offset(b),
+                                    lay.bytes(b), rx.bulk.out.data() + lay.offset(b)});
+            });
+            if (rx.bulk.complete()) {
+                rx.bulk_ok = true;
+                rx.bytes_bulk = std::move(rx.bulk.out);
             }
         }
         
+        // Recupero parziale: anche senza rango pieno i sorgenti gia' determinati dalle righe
+        // ricevute contano nella coverage (al byte) e il prefisso contiguo viene consegnato
+        if (K_crit > 0 && !rx.crit_ok && rx.crit_fresh) {
+            rx.part_crit = rx.crit.partial();
+            rx.crit_fresh = false;
+        }
+        if (K_bulk > 0 && !rx.bulk_ok) {
+            rx.bulk.partial();
+        }
+        
+        bool crit_ok = rx.crit_ok;
+        bool bulk_ok = rx.bulk_ok;
+        const std::vector<uint8_t>& bytes_crit = rx.bytes_crit;
+        const std::vector<uint8_t>& bytes_bulk = rx.bytes_bulk;
+        int symbols_used_crit = rx.used_crit;
+        int symbols_used_bulk = rx.used_bulk;
+        
         result.symbols_used = symbols_used_crit + symbols_used_bulk;
         
-        // Calcola coverage basata su parti ricostruite
-        size_t covered_bytes = 0;
+        // Byte ricostruiti del critico: ogni sorgente noto vale S byte, l'ultimo senza padding
+        size_t crit_known = 0, crit_prefix = 0;
         if (crit_ok) {
-            covered_bytes += bytes_crit.size();
-        }
-        if (bulk_ok) {
-            covered_bytes += bytes_bulk.size();
+            crit_known = crit_prefix = std::min(bytes_crit.size(), expected_critical_size);
+        } else if (K_crit > 0 && rx.part_crit.n == K_crit) {
+            for (int i = 0; i < K_crit; ++i) {
+                size_t off = static_cast<size_t>(i) * symbol_size;
+                if (rx.part_crit.has(i) && off < expected_critical_size) {
+                    crit_known += std::min(symbol_size, expected_critical_size - off);
+                }
+            }
+            crit_prefix = std::min(static_cast<size_t>(rx.part_crit.prefix()) * symbol_size, expected_critical_size);
         }
+        size_t bulk_known = bulk_ok ? bytes_bulk.size() : (K_bulk > 0 ? rx.bulk.known_bytes() : 0);
+        
+        // Calcola coverage basata sui byte ricostruiti
+        size_t covered_bytes = crit_known + bulk_known;
         
         if (expected_total_size > 0) {
             result.coverage = static_cast<double>(covered_bytes) / static_cast<double>(expected_total_size);
             result.coverage = std::clamp(result.coverage, 0.0, 1.0);
         }
         
-        // Componi payload finale
-        if (crit_ok || bulk_ok) {
-            result.payload_bytes.reserve(bytes_crit.size() + bytes_bulk.size());
-            if (crit_ok) {
-                result.payload_bytes.insert(result.payload_bytes.end(), 
-                                          bytes_crit.begin(), bytes_crit.end());
-            }
+        // Componi payload: critico (intero se risolto, altrimenti il suo prefisso noto) e, solo
+        // a critico completo, il prefisso contiguo del bulk
+        if (crit_ok) {
+            // senza il padding dell'ultimo simbolo, come crit_known: il bulk segue subito il critico
+            const size_t crit_bytes = std::min(bytes_crit.size(), expected_critical_size);
+            result.payload_bytes.reserve(crit_bytes + expected_bulk_size);
+            result.payload_bytes.insert(result.payload_bytes.end(), bytes_crit.begin(), bytes_crit.begin() + crit_bytes);
+        } else if (crit_prefix > 0) {
+            result.payload_bytes.assign(rx.part_crit.bytes.begin(), rx.part_crit.bytes.begin() + crit_prefix);
+        }
+        if (crit_ok || K_crit <= 0) {
             if (bulk_ok) {
-                result.payload_bytes.insert(result.payload_bytes.end(), 
-                                          bytes_bulk.begin(), bytes_bulk.end());
+                result.payload_bytes.insert(result.payload_bytes.end(), bytes_bulk.begin(), bytes_bulk.end());
+            } else if (K_bulk > 0) {
+                result.payload_bytes.insert(result.payload_bytes.end(), rx.bulk.out.begin(),
+                                            rx.bulk.out.begin() + rx.bulk.prefix_bytes());
             }
         }
         
@@ -532,18 +841,505 @@ public:
         // Per compatibilità con Engine, manteniamo questa logica conservativa
         result.delivered = (result.coverage >= 1.0);
         
-        // Aggiorna stato adattivo basato sul risultato
-        auto key = make_flow_key(profile);
-        auto it = flow_states_.find(key);
-        if (it != flow_states_.end()) {
-            update_flow_state(profile, it->second, result.coverage, result.delivered,
-                            result.symbols_used, result.total_symbols_seen);
+        // Token completato: i suoi decoder non servono piu' (la geometria resta fino alla scadenza)
+        const bool redelivered = ctx.delivered;
+        if (result.delivered) {
+            ctx.rx.reset();
+            ctx.delivered = true;
+        }
+        lock.unlock();
+        
+        // Aggiorna stato adattivo basato sul risultato (solo flussi gia' spawnati qui, una volta
+        // sola per token consegnato)
+        if (!redelivered) {
+            flow_states_.with(profile.flow_class, profile.priority, [&](FlowState& st) {
+                if (st.initialized) {
+                    update_flow_state(profile, st, result.coverage, result.delivered,
+                                      result.symbols_used, result.total_symbols_seen);
+                }
+            });
+        }
+        
+        return result;
+    }
+    
+    // Geometria a strati normalizzata: ordinata per offset, buchi coperti da strati impliciti di
+    // importanza LAYER_LEVELS - 1, strati vuoti tolti, importanza limitata a LAYER_LEVELS - 1.
+    // std::invalid_argument per strati sovrapposti o fuori dal payload, o oltre MAX_LAYERS
+    static std::vector<PayloadLayer> layer_geometry(std::vector<PayloadLayer> layers, size_t payload_size) {
+        const uint8_t lowest = static_cast<uint8_t>(LAYER_LEVELS - 1);
+        std::stable_sort(layers.begin(), layers.end(), [](const PayloadLayer& a, const PayloadLayer& b) {
+            return a.offset < b.offset;
+        });
+        std::vector<PayloadLayer> out;
+        size_t at = 0;
+        for (const auto& L : layers) {
+            if (L.length == 0) continue;
+            if (L.offset < at || L.offset > payload_size || L.length > payload_size - L.offset) {
+                throw std::invalid_argument("PayloadLayer sovrapposto o fuori dal payload");
+            }
+            if (L.offset > at) out.push_back({at, L.offset - at, lowest});
+            out.push_back({L.offset, L.length, std::min(L.importance, lowest)});
+            at = L.offset + L.length;
+        }
+        if (at < payload_size) out.push_back({at, payload_size - at, lowest});
+        if (out.size() > MAX_LAYERS) {
+            throw std::invalid_argument("troppi strati nel payload");
+        }
+        return out;
+    }
+    
+    // Spawn con protezione disuguale a N strati (vedi PayloadLayer): ogni strato ha i suoi
+    // encoder a blocchi e l'overhead del suo livello (FlowState::layer_overhead). I pacchetti
+    // escono in ordine di importanza, sorgenti e repair di uno strato prima del successivo:
+    // un canale lento o interrotto consegna prima gli strati che contano
+    OrganismSpawnResult spawn_layered(
+        const FlowProfile& profile,
+        const std::string& token_id,
+        const std::vector<uint8_t>& payload_bytes,
+        const std::vector<PayloadLayer>& layers,
+        size_t symbol_size = 0
+    ) {
+        OrganismSpawnResult result;
+        result.payload_size = payload_bytes.size();
+        std::vector<PayloadLayer> geometry = layer_geometry(layers, payload_bytes.size());
+        
+        // Overhead per livello per QUESTO spawn; panic_boost come nello spawn critico/bulk
+        std::array<double, LAYER_LEVELS> ov{};
+        flow_states_.with(profile.flow_class, profile.priority, [&](FlowState& st) {
+            init_flow_state(profile, st);
+            st.age++;
+            ov = st.layer_overhead;
+            if (st.panic_boost > 0) {
+                ov[0] *= 2.0;
+                for (size_t l = 1; l < LAYER_LEVELS; ++l) ov[l] *= 1.5;
+                st.panic_boost -= 1;
+            }
+        });
+        if (symbol_size == 0) symbol_size = symbol_size_for(profile, payload_bytes.size());
+        const fec::TokenHandle token = fec::token_handle(token_id);
+        
+        {
+            auto [lock, ctx] = token_context(token);
+            if (ctx.layers != geometry) {
+                ctx.layer_rx.reset();
+                ctx.notified.clear();
+                ctx.delivered = false;
+            }
+            ctx.K_crit = 0;
+            ctx.K_bulk = 0;
+            ctx.critical_size = 0;
+            ctx.bulk_size = 0;
+            ctx.spawned = true;
+            ctx.rx.reset();
+            ctx.layers = geometry;
+        }
+        
+        // Strati per importanza (a parita', per offset); un encoder sistematico per blocco, repair
+        // MDS per i blocchi che ci stanno (qualsiasi K simboli bastano: header e indici piccoli)
+        std::vector<size_t> order(geometry.size());
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return geometry[a].importance < geometry[b].importance;
+        });
+        std::vector<fec::BlockLayout> layouts(geometry.size());
+        size_t n_enc = 0;
+        for (size_t l = 0; l < geometry.size(); ++l) {
+            layouts[l] = fec::block_layout(geometry[l].length, symbol_size);
+            n_enc += layouts[l].Z;
+        }
+        std::vector<fec::Encoder> encs;
+        std::vector<std::pair<uint8_t, uint32_t>> tags;   // (strato, blocco) di ogni encoder
+        std::vector<int> counts;
+        encs.reserve(n_enc);
+        result.K = 0;
+        for (size_t l : order) {
+            const PayloadLayer& L = geometry[l];
+            const fec::BlockLayout& lay = layouts[l];
+            for (uint32_t b = 0; b < lay.Z; ++b) {
+                encs.emplace_back(payload_bytes.data() + L.offset + lay.offset(b), lay.bytes(b), symbol_size);
+                encs.back().systematic = true;
+                encs.back().mds = fec::mds_fits(encs.back().N());
+                const int Kb = encs.back().N();
+                counts.push_back(std::max(Kb, static_cast<int>(std::ceil(Kb * ov[L.importance]))));
+                tags.push_back({static_cast<uint8_t>(l), b});
+            }
+            result.K += static_cast<int>(lay.Kt);
+        }
+        
+        std::vector<fec::Fp> fps(static_cast<size_t>(std::accumulate(counts.begin(), counts.end(), 0)));
+        std::vector<fec::EmitBatch> batches;
+        size_t at = 0;
+        for (size_t e = 0; e < encs.size(); ++e) {
+            batches.push_back({&encs[e], static_cast<size_t>(counts[e]), fps.data() + at});
+            at += static_cast<size_t>(counts[e]);
         }
+        fec::emit_batches(batches.data(), batches.size());
         
+        result.packets.reserve(fps.size());
+        at = 0;
+        for (size_t e = 0; e < encs.size(); ++e) {
+            for (int i = 0; i < counts[e]; ++i) {
+                result.packets.push_back({fps[at++], 0, token, fec::SegmentKind::LAYER, tags[e].second,
+                                          static_cast<uint16_t>(symbol_size), tags[e].first});
+            }
+        }
+        for (auto& enc : encs) result.slabs.push_back(enc.take_slab());
         return result;
     }
     
+    // Callback chiamata da integrate()/integrate_layered() per ogni segmento appena ricostruito
+    // (vedi SegmentDelivery), una volta per segmento anche se il token si reintegra dopo la
+    // consegna. Gira con il lock dello shard del token, anche su un worker del pool per i
+    // blocchi del bulk (chiamate serializzate per token): non deve richiamare l'organismo.
+    // Da impostare prima di usare l'organismo da piu' thread
+    void set_delivery_callback(DeliveryCallback cb) {
+        on_delivery_ = std::move(cb);
+    }
+    
+    // Integra un token a strati: ogni strato si rilascia in result.layers appena si completa,
+    // senza aspettare gli altri. La geometria viene dallo spawn_layered su questo organismo;
+    // un ricevitore remoto passa gli stessi layers e payload_size del mittente. Anche
+    // integrate() riconosce un token a strati gia' noto e passa di qui
+    OrganismIntegrateResult integrate_layered(
+        const FlowProfile& profile,
+        const std::string& token_id,
+        const std::vector<fec::Pkt>& received_packets,
+        const std::vector<PayloadLayer>& layers = {},
+        size_t payload_size = 0
+    ) {
+        const fec::TokenHandle token = fec::token_handle(token_id);
+        size_t symbol_size = 0;
+        for (const auto& p : received_packets) {
+            if (p.token == token && p.sym != 0) { symbol_size = p.sym; break; }
+        }
+        auto [lock, ctx] = token_context(token);
+        if (payload_size > 0) {
+            std::vector<PayloadLayer> geometry = layer_geometry(layers, payload_size);
+            if (ctx.layers != geometry) {
+                ctx.layers = std::move(geometry);
+                ctx.layer_rx.reset();
+                ctx.notified.clear();
+                ctx.delivered = false;
+            }
+        }
+        if (ctx.layers.empty() || symbol_size == 0) return OrganismIntegrateResult{};
+        return integrate_layers(profile, token, symbol_size, received_packets, lock, ctx);
+    }
+    
+    // Modo streaming per flussi NERVE: invece di un Token con il suo codice a blocco per
+    // ogni messaggio, il messaggio esce subito come simbolo sorgente seguito dai repair a
+    // finestra scorrevole che gli spettano (crit_overhead - 1 per messaggio, accumulato).
+    // Il messaggio deve stare in symbol_size - 2 byte (std::length_error altrimenti)
+    std::vector<fec::SwSymbol> stream_send(
+        const FlowProfile& profile,
+        const std::string& stream_id,
+        const std::vector<uint8_t>& msg,
+        size_t symbol_size = 128
+    ) {
+        const FlowState st = flow_state(profile);
+        auto it = stream_tx_.find(stream_id);
+        if (it == stream_tx_.end()) {
+            it = stream_tx_.emplace(stream_id, StreamTx{fec::SlidingWindowEncoder(symbol_size, STREAM_WINDOW)}).first;
+        }
+        StreamTx& tx = it->second;
+        
+        std::vector<fec::SwSymbol> out;
+        out.push_back(tx.enc.push(msg));
+        tx.repair_credit += std::max(st.crit_overhead - 1.0, 0.0);
+        while (tx.repair_credit >= 1.0) {
+            out.push_back(tx.enc.repair());
+            tx.repair_credit -= 1.0;
+        }
+        return out;
+    }
+    
+    // Integra un simbolo dello stream: ritorna i messaggi consegnabili in ordine, appena
+    // ricostruiti (lost = true per quelli che nessun repair puo' piu' recuperare)
+    std::vector<fec::SwDelivery> stream_receive(
+        const std::string& stream_id,
+        const fec::SwSymbol& symbol,
+        size_t symbol_size = 128
+    ) {
+        auto it = stream_rx_.find(stream_id);
+        if (it == stream_rx_.end()) {
+            it = stream_rx_.emplace(stream_id, fec::SlidingWindowDecoder(symbol_size, STREAM_WINDOW)).first;
+        }
+        return it->second.push(symbol);
+    }
+    
+    // Feedback opzionale: i messaggi < next_seq sono consegnati, i repair successivi non li coprono
+    void stream_ack(const std::string& stream_id, uint32_t next_seq) {
+        auto it = stream_tx_.find(stream_id);
+        if (it != stream_tx_.end()) it->second.enc.ack(next_seq);
+    }
+    
+    // Token con un contesto vivo (spawnati o in ricezione, non ancora scaduti). I contesti
+    // scaduti ma non ancora liberati (la pulizia avviene shard per shard) non contano
+    size_t active_tokens() const {
+        const uint64_t ttl = token_ttl_.load();
+        size_t n = 0;
+        for (const TokenShard& shard : token_shards_) {
+            std::lock_guard<std::mutex> lk(shard.mu);
+            const uint64_t now = tick_.load();
+            for (const auto& [token, ctx] : shard.map) {
+                if (ctx.last_use + ttl >= now) ++n;
+            }
+        }
+        return n;
+    }
+    
+    // Limiti della tabella dei token: contesti al massimo, chiamate spawn/integrate senza uso
+    // prima della scadenza. Applicati subito a tutta la tabella
+    void set_token_expiry(size_t max_tokens, uint64_t ttl_calls) {
+        max_tokens_ = std::max<size_t>(max_tokens, 1);
+        token_ttl_ = std::max<uint64_t>(ttl_calls, 1);
+        for (TokenShard& shard : token_shards_) {
+            std::lock_guard<std::mutex> lk(shard.mu);
+            expire_tokens(shard);
+        }
+        make_room(max_tokens_.load() + 1);
+    }
+    
+    // Stato adattivo corrente di un tipo di flusso (copia)
+    FlowState flow_state(FlowClass cls, Priority prio) const {
+        return flow_states_.get(cls, prio);
+    }
+    
 private:
+    // Shard del token: moltiplicazione di Fibonacci, i bit alti scelgono lo shard
+    TokenShard& token_shard(fec::TokenHandle token) {
+        return token_shards_[(token * 0x9E3779B97F4A7C15ULL) >> 60];
+    }
+    static_assert(TOKEN_SHARDS == 16, "token_shard() usa i 4 bit alti dell'hash");
+    
+    // Fa scadere i contesti dello shard inattivi da piu' di token_ttl_ chiamate (shard gia'
+    // bloccato dal chiamante)
+    void expire_tokens(TokenShard& shard) {
+        const uint64_t now = tick_.load();
+        const uint64_t ttl = token_ttl_.load();
+        for (auto it = shard.map.begin(); it != shard.map.end();) {
+            if (it->second.last_use + ttl < now) {
+                it = shard.map.erase(it);
+                token_count_.fetch_sub(1);
+            } else {
+                ++it;
+            }
+        }
+    }
+    
+    // Porta la tabella sotto `limit` contesti: fa scadere gli inattivi di tutti gli shard e, se non
+    // basta, libera i meno usati di recente dell'intera tabella. Blocca uno shard alla volta, il
+    // chiamante non deve tenere lock di shard. Con inserimenti concorrenti la tabella puo' superare
+    // max_tokens_ al piu' di un contesto per thread, finche' il prossimo inserimento non la riporta giu'
+    void make_room(size_t limit) {
+        while (token_count_.load() >= limit) {
+            TokenShard* victim = nullptr;
+            uint64_t oldest = UINT64_MAX;
+            for (TokenShard& shard : token_shards_) {
+                std::lock_guard<std::mutex> lk(shard.mu);
+                expire_tokens(shard);
+                for (const auto& [token, ctx] : shard.map) {
+                    if (ctx.last_use < oldest) {
+                        oldest = ctx.last_use;
+                        victim = &shard;
+                    }
+                }
+            }
+            if (token_count_.load() < limit || !victim) return;
+            std::lock_guard<std::mutex> lk(victim->mu);
+            auto it = std::min_element(victim->map.begin(), victim->map.end(), [](const auto& a, const auto& b) {
+                return a.second.last_use < b.second.last_use;
+            });
+            if (it != victim->map.end()) {
+                victim->map.erase(it);
+                token_count_.fetch_sub(1);
+            }
+        }
+    }
+    
+    // Contesto del token (creato se manca) con il lock del suo shard, dopo aver fatto scadere
+    // quelli inattivi dello shard. Un contesto nuovo a tabella piena (token_count_ a max_tokens_)
+    // prima fa spazio su tutta la tabella, senza il lock di questo shard
+    LockedContext token_context(fec::TokenHandle token) {
+        TokenShard& shard = token_shard(token);
+        std::unique_lock<std::mutex> lock(shard.mu);
+        const uint64_t now = ++tick_;
+        expire_tokens(shard);
+        auto found = shard.map.find(token);
+        if (found == shard.map.end() && token_count_.load() >= max_tokens_.load()) {
+            lock.unlock();
+            make_room(max_tokens_.load());
+            lock.lock();
+            found = shard.map.find(token);   // nel frattempo un altro thread puo' averlo creato
+        }
+        if (found == shard.map.end()) {
+            found = shard.map.emplace(token, TokenContext{}).first;
+            token_count_.fetch_add(1);
+        }
+        found->second.last_use = now;
+        return {std::move(lock), found->second};
+    }
+    
+    // Stato adattivo del tipo di flusso (copia), inizializzato al primo uso
+    FlowState flow_state(const FlowProfile& profile) {
+        return flow_states_.with(profile.flow_class, profile.priority, [&](FlowState& st) {
+            init_flow_state(profile, st);
+            return st;
+        });
+    }
+    
+    // Inizializza genotipo e overhead di base della voce, se non ancora fatto (voce bloccata)
+    void init_flow_state(const FlowProfile& profile, FlowState& st) {
+        // FASE 5b: Inizializza genotipo se non ancora fatto
+        if (!st.initialized) {
+            st.genotype = from_hint(profile.genotype_hint, profile);
+            st.initialized = true;
+            st.age = 0;
+            
+            // Log una tantum quando il genotipo viene inizializzato
+            std::cout << "[ALIEN][GENO] class=" << profile.flow_class
+                      << " priority=" << profile.priority
+                      << " genotype=" << genotype_to_string(st.genotype) << std::endl;
+        }
+        
+        // Prima volta: inizializza dai fattori statici esistenti
+        if (st.base_crit_overhead == 1.0 && st.base_bulk_overhead == 1.0 &&
+            st.success_count == 0 && st.fail_count == 0 && st.avg_coverage == 0.0) {
+            // Prima volta: inizializza dai fattori statici esistenti
+            st.base_crit_overhead = crit_overhead_factor(profile);
+            st.base_bulk_overhead = bulk_overhead_factor(profile);
+            st.crit_overhead = st.base_crit_overhead;
+            st.bulk_overhead = st.base_bulk_overhead;
+            // Strati: dal fattore critico (importanza 0) a quello bulk (importanza minima)
+            for (size_t l = 0; l < LAYER_LEVELS; ++l) {
+                const double t = static_cast<double>(l) / static_cast<double>(LAYER_LEVELS - 1);
+                st.base_layer_overhead[l] = st.base_crit_overhead + (st.base_bulk_overhead - st.base_crit_overhead) * t;
+                st.layer_overhead[l] = st.base_layer_overhead[l];
+            }
+        }
+    }
+    
+    // Prima notifica del segmento i del token: chiama la callback (se c'e') e ritorna true;
+    // false se il segmento era gia' stato notificato
+    bool notify(TokenContext& ctx, size_t i, const SegmentDelivery& seg) {
+        if (ctx.notified.size() <= i) ctx.notified.resize(i + 1, 0);
+        if (ctx.notified[i]) return false;
+        ctx.notified[i] = 1;
+        if (on_delivery_) on_delivery_(seg);
+        return true;
+    }
+    
+    // Decodifica a strati del token (lock dello shard preso dal chiamante, rilasciato qui prima
+    // di aggiornare lo stato adattivo)
+    OrganismIntegrateResult integrate_layers(
+        const FlowProfile& profile,
+        fec::TokenHandle token,
+        size_t symbol_size,
+        const std::vector<fec::Pkt>& received_packets,
+        std::unique_lock<std::mutex>& lock,
+        TokenContext& ctx
+    ) {
+        OrganismIntegrateResult result;
+        if (ctx.layer_rx && ctx.layer_rx->symbol_size != symbol_size) {
+            ctx.layer_rx.reset();
+            ctx.notified.clear();
+            ctx.delivered = false;
+        }
+        if (ctx.layer_rx && received_packets.size() < ctx.layer_rx->fed) {
+            ctx.layer_rx.reset();
+        }
+        if (!ctx.layer_rx) ctx.layer_rx = std::make_unique<LayerDecoders>(ctx.layers, symbol_size);
+        LayerDecoders& rx = *ctx.layer_rx;
+        
+        for (; rx.fed < received_packets.size(); ++rx.fed) {
+            const auto& p = received_packets[rx.fed];
+            if (p.token != token) continue;
+            rx.seen++;
+            if (p.kind != fec::SegmentKind::LAYER || p.layer >= rx.dec.size() || rx.released[p.layer]) continue;
+            if (rx.dec[p.layer].push(p.block, p.fp)) rx.used++;
+        }
+        result.total_symbols_seen = rx.seen;
+        result.symbols_used = rx.used;
+        if (rx.seen == 0) return result;
+        
+        // Strati completati in questa chiamata: rilasciati subito; gli altri contano per i byte noti
+        size_t known = 0, total = 0;
+        bool all = true;
+        std::array<bool, LAYER_LEVELS> level_missing{};
+        for (size_t l = 0; l < rx.dec.size(); ++l) {
+            fec::BlockedDecoder& d = rx.dec[l];
+            const PayloadLayer& L = ctx.layers[l];
+            if (!rx.released[l]) {
+                d.solve_ready();
+                if (d.complete()) {
+                    rx.released[l] = 1;
+                    if (notify(ctx, l, {token, fec::SegmentKind::LAYER, static_cast<uint32_t>(l), L.offset,
+                                        L.length, d.out.data()})) {
+                        result.layers.push_back({L.offset, L.importance, d.out});
+                    }
+                } else {
+                    d.partial();
+                }
+            }
+            known += rx.released[l] ? L.length : d.known_bytes();
+            total += L.length;
+            if (!rx.released[l]) {
+                all = false;
+                level_missing[L.importance] = true;
+            }
+        }
+        result.coverage = total > 0 ? static_cast<double>(known) / static_cast<double>(total) : 1.0;
+        result.delivered = all;
+        
+        // Payload: strati in ordine di offset fino al primo incompleto, di questo il prefisso noto
+        for (size_t l = 0; l < rx.dec.size(); ++l) {
+            const fec::BlockedDecoder& d = rx.dec[l];
+            if (rx.released[l]) {
+                result.payload_bytes.insert(result.payload_bytes.end(), d.out.begin(), d.out.end());
+            } else {
+                result.payload_bytes.insert(result.payload_bytes.end(), d.out.begin(), d.out.begin() + d.prefix_bytes());
+                break;
+            }
+        }
+        const bool redelivered = ctx.delivered;
+        if (result.delivered) {
+            ctx.layer_rx.reset();
+            ctx.delivered = true;
+        }
+        lock.unlock();
+        
+        if (redelivered) return result;
+        flow_states_.with(profile.flow_class, profile.priority, [&](FlowState& st) {
+            if (st.initialized) {
+                update_flow_state(profile, st, result.coverage, result.delivered,
+                                  result.symbols_used, result.total_symbols_seen);
+                update_layer_overheads(profile, st, result.delivered, level_missing);
+            }
+        });
+        return result;
+    }
+    
+    // Overhead per livello: sale per i livelli rimasti incompleti (piu' per i piu' importanti),
+    // scende verso la base con la stessa calma richiesta da update_flow_state per il dimagrimento
+    void update_layer_overheads(
+        const FlowProfile& profile,
+        FlowState& st,
+        bool delivered,
+        const std::array<bool, LAYER_LEVELS>& level_missing
+    ) {
+        auto gp = params_for(profile, st);
+        for (size_t l = 0; l < LAYER_LEVELS; ++l) {
+            double& ov = st.layer_overhead[l];
+            if (!delivered && level_missing[l]) {
+                ov += gp.alpha_up * gp.panic_multiplier * (l == 0 ? 1.0 : 0.5);
+            } else if (delivered && st.panic_boost == 0 && st.good_streak >= GOOD_STREAK_THRESHOLD) {
+                ov -= gp.alpha_down;
+            }
+            ov = std::clamp(ov, st.base_layer_overhead[l], std::max(gp.max_overhead, st.base_layer_overhead[l]));
+        }
+    }
+    
     // Aggiorna stato adattivo: memoria immunitaria + panic mode
     void update_flow_state(
         const FlowProfile& profile,
@@ -624,7 +1420,6 @@ private:
         
         // FASE 3b TASK 4: Dimagrimento lento basato sullo stato calmo
         // NON dipende da efficiency (che nel test è sempre 1.0)
-        const int GOOD_STREAK_THRESHOLD = 4;      // almeno 4 successi "calmi" di fila
         const double COV_GOOD_THRESHOLD = 0.85;   // copertura media alta (abbassato da 0.90 per attivazione più realistica)
         
         if (delivered &&
@@ -653,32 +1448,29 @@ private:
         st.crit_overhead = std::clamp(st.crit_overhead, MIN_OV, max_overhead);
         st.bulk_overhead = std::clamp(st.bulk_overhead, MIN_OV, max_overhead);
         
-        // Log adattivo
-        std::string cls_name;
-        switch (profile.flow_class) {
-            case FlowClass::NERVE:  cls_name = "NERVE"; break;
-            case FlowClass::GLAND:  cls_name = "GLAND"; break;
-            case FlowClass::MUSCLE: cls_name = "MUSCLE"; break;
-        }
-        
         // FASE 3b TASK 6: Log esteso con streak
         // FASE 5b: Aggiungi genotipo al log
-        std::cout << "[ALIEN][ADAPT] class=" << cls_name
-                  << " priority=" << profile.priority
-                  << " cov=" << std::fixed << std::setprecision(2) << coverage
-                  << " avg_cov=" << st.avg_coverage
-                  << " delivered=" << (delivered ? "true" : "false")
-                  << " used=" << symbols_used
-                  << "/" << total_symbols_seen
-                  << " crit_ov=" << st.crit_overhead
-                  << " bulk_ov=" << st.bulk_overhead
-                  << " panic=" << st.panic_boost
-                  << " gs=" << st.good_streak
-                  << " bs=" << st.bad_streak
-                  << " geno=" << genotype_to_string(st.genotype)
-                  << std::endl;
+        // Riga composta a parte e scritta in un colpo: formato locale, niente righe spezzate
+        // tra thread che integrano flussi diversi
+        std::ostringstream log;
+        log << "[ALIEN][ADAPT] class=" << profile.flow_class
+            << " priority=" << profile.priority
+            << " cov=" << std::fixed << std::setprecision(2) << coverage
+            << " avg_cov=" << st.avg_coverage
+            << " delivered=" << (delivered ? "true" : "false")
+            << " used=" << symbols_used
+            << "/" << total_symbols_seen
+            << " crit_ov=" << st.crit_overhead
+            << " bulk_ov=" << st.bulk_overhead
+            << " panic=" << st.panic_boost
+            << " gs=" << st.good_streak
+            << " bs=" << st.bad_streak
+            << " geno=" << genotype_to_string(st.genotype)
+            << '\n';
+        std::cout << log.str() << std::flush;
     }
 };
 
 } // namespace aurora
 
+#endif // AURORA_EMBEDDED
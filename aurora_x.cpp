@@ -1,13 +1,14 @@
 // aurora_x.cpp - UPDATED VERSION (Nexus patch)
 // AURORA-X - Extreme Field Orchestrator (3-file repo)
 // Build Dev:   g++ -std=c++20 -O3 -pthread aurora_x.cpp -o aurora_x
-// Build Field: g++ -std=c++20 -O3 -pthread -DFIELD_BUILD -DAURORA_USE_REAL_CRYPTO -DAURORA_USE_RAPTORQ_REAL aurora_x.cpp -lsodium -o aurora_x_field
+// Build Field: g++ -std=c++20 -O3 -pthread -DFIELD_BUILD -DAURORA_USE_REAL_CRYPTO -DAURORA_USE_RAPTORQ aurora_x.cpp src/fec/AuroraRaptorQ.cpp -Isrc -lsodium -o aurora_x_field
 
 #include <iostream>
 #include <vector>
 #include <string>
 #include <array>
 #include <memory>
+#include <functional>
 #include <unordered_set>
 #include <cmath>
 #include <algorithm>
@@ -27,7 +28,7 @@ using namespace std; using namespace chrono;
 #include "aurora_extreme.hpp"
 #include "aurora_organism.hpp"
 #include "src/core/AuroraSafetyMonitor.hpp"
-#ifdef AURORA_USE_LIBRAPTORQ
+#ifdef AURORA_USE_RAPTORQ
 #include "fec/AuroraRaptorQ.hpp"
 #endif
 
@@ -208,13 +209,20 @@ struct Node {
   vector<fec::Pkt> buf, inbox; unordered_set<uint32_t> seen;
   double harvest_W = 0.2;
   size_t tx_idx = 0; // NEW: rotating cursor to avoid resending same packet
+  vector<uint8_t> frame_buf; // frame PHY riusato tra le trasmissioni
+  // Ammissione al ricevitore: false = simbolo non innovativo, marcato come visto ma non tenuto in buf
+  function<bool(const fec::Pkt&)> admit;
+  size_t rejected = 0;
 
   void tick(double dt){ bat.harvest(harvest_W, dt); }
-  void ingest(){ for(auto&p: inbox) if(!seen.count(p.seq)){ buf.push_back(p); seen.insert(p.seq);} inbox.clear(); }
+  void ingest(){
+    for(auto&p: inbox) if(seen.insert(p.seq).second){ if(!admit || admit(p)) buf.push_back(p); else ++rejected; }
+    inbox.clear();
+  }
   bool send_one(world::World& W, Node& rx, phy::Mode m){
     if(buf.empty()) return false;
     if(tx_idx >= buf.size()) tx_idx = 0; // ring safety
-    auto pkt = buf[tx_idx];              // rotate across distinct packets
+    const fec::Pkt& pkt = buf[tx_idx];  // rotate across distinct packets
     tx_idx = (tx_idx + 1) % max<size_t>(1, buf.size());
 
     size_t B = pkt.fp.data.size()+8;
@@ -228,13 +236,13 @@ struct Node {
     // size shaping safe - padding solo nel frame PHY (non parte del FEC/Merkle)
     if(m==phy::Mode::RF){
       int pad = (int)(util::rng.uni()*12);
-      vector<uint8_t> frame = pkt.fp.data; frame.resize(frame.size()+pad, (uint8_t)(0xA5 ^ pad));
-      HAL::LORA_TX(frame.data(), frame.size());
+      frame_buf.assign(pkt.fp.data.begin(), pkt.fp.data.end()); frame_buf.resize(frame_buf.size()+pad, (uint8_t)(0xA5 ^ pad));
+      HAL::LORA_TX(frame_buf.data(), frame_buf.size());
     } else if(m==phy::Mode::IR){
       HAL::IR_TX(pkt.fp.data.data(), pkt.fp.data.size(), 3500 + (int)(util::rng.uni()*1200));
     } else {
-      vector<uint8_t> bits( pkt.fp.data.size()*8, 1 );
-      HAL::BS_MODULATE(bits.data(), bits.size(), 450 + (int)(util::rng.uni()*200));
+      frame_buf.assign(pkt.fp.data.size()*8, 1);
+      HAL::BS_MODULATE(frame_buf.data(), frame_buf.size(), 450 + (int)(util::rng.uni()*200));
     }
     return ok;
   }
@@ -263,10 +271,29 @@ using FlowHealth = cl::FlowHealth;
 
 struct Engine {
   Net net; Intention I; string token_id, bundle_id; int K; 
-  size_t T=128;  // mantenuto 128 per FEC piu rapido
+  fec::TokenHandle token=0;   // token_id sul filo e nei buffer (fec::token_handle)
+  size_t T=128;  // byte per simbolo: in init() lo sceglie l'organismo per flusso e payload
   size_t payload_size;
   uint32_t seqc=1;
   uint32_t RqRepair=0; // numero simboli di riparazione (RaptorQ)
+  // Byte dei simboli del token: i Pkt nei buffer dei nodi sono viste in queste slab
+  // (codec LT: in quelle degli encoder, tenuti per i repair mirati dal feedback)
+  vector<fec::SymbolSlab> tx_slabs;
+  vector<fec::Encoder> tx_encs;
+  // Canale di ritorno DST->SRC: ogni FEEDBACK_EVERY step, per i flussi che lo vogliono,
+  // DST manda i sorgenti mancanti di ogni blocco e SRC mette in testa alla rotazione
+  // repair mirati (mancanti + FEEDBACK_MARGIN, al piu' FEEDBACK_MAX per blocco)
+  bool back_channel = true;
+  static constexpr int FEEDBACK_EVERY = 4;
+  static constexpr size_t FEEDBACK_MARGIN = 2, FEEDBACK_MAX = 64;
+  size_t fb_msgs = 0, fb_bytes = 0, fb_syms = 0;
+  // Decoder persistente del token (uno per blocco sorgente): elimina i simboli man mano che arrivano in DST
+  // DST.admit passa ogni simbolo nuovo a rx_dec e tiene in DST.buf solo quelli innovativi
+  fec::BlockedDecoder rx_dec{fec::BlockLayout{}};
+  size_t rx_fed = 0;   // pacchetti di DST.buf gia' visti da rx_step
+#ifdef AURORA_USE_RAPTORQ
+  unique_ptr<aurora::fec::RqDecoder> rq_dec;   // stesso ruolo di rx_dec per il codec RaptorQ
+#endif
   TelemetrySink telemetry;
   
   // FASE 4: Organismo adattivo e health tracking
@@ -297,12 +324,15 @@ struct Engine {
     HAL::RADIO_INIT();
     HAL::LORA_CFG(phy::EU868_CH[0], 125, 12, 5, 12);
     net.add("SRC",{0.06,0.08}); net.add("DST",{0.94,0.92});
+    net.get("DST")->admit = [this](const fec::Pkt& p){ return rx_admit(p); };
 
     Token t = Token::make("ACCESS:TEMP_KEY=abc123;ZONE=42;TTL=24h;CLASS=NORM;", 24*3600);
-    Bundle b = Bundle::make(t); token_id=t.id; bundle_id=b.bid;
+    Bundle b = Bundle::make(t); token_id=t.id; token=fec::token_handle(token_id); bundle_id=b.bid;
     auto bytes = tok2bytes(t);
     payload_size = bytes.size();
-#ifdef AURORA_USE_LIBRAPTORQ
+    T = organism->symbol_size_for(organism->build_profile(I), bytes.size());
+    const uint16_t sym = (uint16_t)T;   // viaggia in ogni Pkt: il ricevitore decodifica con questa
+#ifdef AURORA_USE_RAPTORQ
     {
       aurora::fec::AuroraRaptorQ rq;
       // calcola K dai parametri, repair ~20% per affidabilita 0.99
@@ -312,16 +342,88 @@ struct Engine {
       K = (int)((bytes.size()+T-1)/T);
       cout << "[DEBUG] FEC(RQ) Parameters: K=" << K << " T=" << T
            << " R=" << RqRepair << " (ESI 0.." << (K+RqRepair-1) << ")" << endl;
-      for (const auto& s : symbols){ fec::Fp fp; fp.seed = s.esi; fp.deg = 1; fp.data = s.bytes; net.get("SRC")->buf.push_back({fp, seqc++, token_id}); }
+      auto& slab = tx_slabs.emplace_back(T); slab.reserve(symbols.size());
+      for (const auto& s : symbols){ fec::Fp fp; fp.seed = s.esi; fp.deg = 1; fp.data = slab.add(s.bytes); net.get("SRC")->buf.push_back({fp, seqc++, token, fec::SegmentKind::BULK, 0, sym}); }
+      rq_dec = rq.make_decoder(payload_size, T); rx_fed = 0;
     }
 #else
-    fec::Encoder enc(bytes, T); K = enc.N();
-    cout << "[DEBUG] FEC Parameters: K=" << K << " T=" << T 
+    // blocchi sorgente da al piu' fec::BLOCK_MAX_K simboli, un encoder e un pool LT per blocco
+    fec::BlockLayout lay = fec::block_layout(bytes.size(), T); K = (int)lay.Kt;
+    vector<fec::Encoder>& encs = tx_encs; encs.clear(); encs.reserve(lay.Z);
+    for(uint32_t b=0;b<lay.Z;++b){ encs.emplace_back(bytes.data()+lay.offset(b), lay.bytes(b), T); encs.back().systematic = true; }  // primi K in chiaro
+    rx_dec = fec::BlockedDecoder(lay); rx_fed = 0;
+    cout << "[DEBUG] FEC Parameters: K=" << K << " T=" << T << " blocks=" << lay.Z
          << " (need " << K << " packets to decode)" << endl;
-    for(int i=0;i<K*3; ++i){ auto fp = enc.emit(); net.get("SRC")->buf.push_back({fp, seqc++, token_id}); }
+    vector<size_t> pools(lay.Z); size_t total = 0;
+    for(uint32_t b=0;b<lay.Z;++b){ pools[b] = fec::lt_pool_size(encs[b].N()); total += pools[b]; }
+    vector<fec::Fp> fps(total); vector<fec::EmitBatch> batches; size_t at = 0;
+    for(uint32_t b=0;b<lay.Z;++b){ batches.push_back({&encs[b], pools[b], fps.data()+at}); at += pools[b]; }
+    fec::emit_batches(batches.data(), batches.size());
+    at = 0;
+    for(uint32_t b=0;b<lay.Z;++b) for(size_t i=0;i<pools[b];++i) net.get("SRC")->buf.push_back({fps[at++], seqc++, token, fec::SegmentKind::BULK, b, sym});
+#endif
+  }
+
+  // Un giro del canale di ritorno (solo codec LT): hint dei blocchi incompleti da DST a SRC,
+  // che li applica ai suoi encoder e accoda i repair mirati come prossimi da trasmettere
+  void feedback_step(int step, const aurora::FlowProfile& profile){
+#ifndef AURORA_USE_RAPTORQ
+    if(!back_channel || tx_encs.empty() || step % FEEDBACK_EVERY != FEEDBACK_EVERY-1 || !organism->wants_feedback(profile)) return;
+    Node& S=*net.get("SRC");
+    rx_dec.partial();
+    vector<fec::Pkt> extra;
+    size_t hinted = 0, hint_bytes = 0;   // hint mandati in questo giro; fb_* sono i totali
+    for(uint32_t b=0;b<rx_dec.lay.Z;++b){
+      if(rx_dec.block_done(b)) continue;
+      vector<uint8_t> wire = rx_dec.hint(b).pack(); ++hinted; hint_bytes += wire.size() + 4;   // + sbn
+      fec::Hint h; if(!fec::Hint::unpack(wire.data(), wire.size(), h) || h.empty()) continue;
+      size_t n = min(h.n_missing + FEEDBACK_MARGIN, FEEDBACK_MAX);
+      tx_encs[b].hint = move(h);
+      for(size_t i=0;i<n;++i) extra.push_back({tx_encs[b].emit(), seqc++, token, fec::SegmentKind::BULK, b, (uint16_t)T});
+    }
+    fb_msgs += hinted; fb_bytes += hint_bytes;
+    if(extra.empty()) return;
+    fb_syms += extra.size();
+    size_t at = min(S.tx_idx, S.buf.size());
+    S.buf.insert(S.buf.begin()+at, extra.begin(), extra.end());
+    cout << "[FEEDBACK] step=" << step << " blocks=" << hinted << " bytes=" << hint_bytes << " repair=" << extra.size()
+         << " (totale blocks=" << fb_msgs << " bytes=" << fb_bytes << " repair=" << fb_syms << ")\n";
+#else
+    (void)step; (void)profile;
 #endif
   }
 
+  // Ammissione in DST: il simbolo entra subito nel decoder del token, in buf solo se innovativo.
+  // RaptorQ non tiene il rango tra un decode() e l'altro: scarta solo duplicati e simboli a decode finito.
+  bool rx_admit(const fec::Pkt& p){
+    if (p.token != token) return true;
+#ifdef AURORA_USE_RAPTORQ
+    return rq_dec && rq_dec->add(p.fp.seed, p.fp.data.data(), p.fp.data.size());
+#else
+    return rx_dec.push(p.block, p.fp);
+#endif
+  }
+
+  // I simboli ammessi in D sono gia' nel decoder del token: se il sistema puo' avere rango
+  // pieno tenta la decodifica. true = payload in out.
+  bool rx_step(const Node& D, vector<uint8_t>& out, vector<fec::SymView>* used = nullptr){
+    for (; rx_fed < D.buf.size(); ++rx_fed) {
+      const auto& p = D.buf[rx_fed];
+      if (p.token == token && used) used->push_back(p.fp.data);
+    }
+#ifdef AURORA_USE_RAPTORQ
+    if (!rq_dec->ready()) return false;
+    auto maybe = rq_dec->decode();
+    if (!maybe) return false;
+    out = std::move(*maybe);
+#else
+    rx_dec.solve_ready();   // blocchi pronti in parallelo
+    if (!rx_dec.complete()) return false;
+    out = rx_dec.out;
+#endif
+    return true;
+  }
+
   static double entropy_residual(int have, int need){ double e=max(0, need-have)/(double)need; return min(1.0,max(0.0,e)); }
   
   // T1: Emette evento JSON health su stdout
@@ -492,7 +594,7 @@ struct Engine {
   bool run(){
     using HAL::FHSS_next;
     Node& S=*net.get("SRC"); Node& D=*net.get("DST");
-    vector<vector<uint8_t>> used; auto t0=steady_clock::now();
+    vector<fec::SymView> used; auto t0=steady_clock::now();
     bool delivered=false; vector<uint8_t> out;
 
     cl::Optimizer opt;
@@ -513,7 +615,7 @@ struct Engine {
       // tick/ingest
       for(auto& n: net.nodes) n->tick(1.0), n->ingest();
 
-      int have=0; for(auto& p:D.buf) if(p.token_id==token_id) have++;
+      int have=0; for(auto& p:D.buf) if(p.token==token) have++;
       double eres=entropy_residual(have,K);
 
       // progress
@@ -610,7 +712,7 @@ struct Engine {
       opt.feedback(dec.mode, reward);
       if(emergency){ cout<<"[COVERT] EMERGENCY flag; seq="<<(int)covert_seq<<"\n"; }
 
-      int have_after = 0; for (auto& p : D.buf) if (p.token_id == token_id) have_after++;
+      int have_after = 0; for (auto& p : D.buf) if (p.token == token) have_after++;
       
       // FASE 4: Integra organismo per ottenere risultati reali
       aurora::FlowProfile flow_profile = organism->build_profile(I);
@@ -618,7 +720,7 @@ struct Engine {
       // Raccogli pacchetti ricevuti per questo token_id
       vector<fec::Pkt> received_packets;
       for (auto& p : D.buf) {
-        if (p.token_id == token_id) {
+        if (p.token == token) {
           received_packets.push_back(p);
         }
       }
@@ -724,42 +826,13 @@ struct Engine {
       telemetry.record(sample);
 
       // === EARLY-EXIT FEC ===
-#ifdef AURORA_USE_LIBRAPTORQ
-      {
-        if (have_after >= std::min(K + (int)RqRepair, have_after)) {
-          aurora::fec::AuroraRaptorQ rq; auto dec = rq.make_decoder(payload_size, T);
-          int fed = 0;
-          for (auto& p : D.buf){ if (p.token_id==token_id){ aurora::fec::EncodedSymbol s{ (uint32_t)p.fp.seed, p.fp.data }; dec->add(s); if(++fed >= K + (int)RqRepair) break; } }
-          if (dec->ready()){
-            auto maybe = dec->decode();
-            if (maybe){ out = std::move(*maybe); delivered = true; cout << "[SUCCESS] RQ decode with " << fed << " symbols" << endl; }
-          }
-        }
-      }
-#else
-      {
-        if (have_after >= K) {
-          fec::Decoder fast_dec(K, T); int fed = 0;
-          for (auto& p : D.buf) { if (p.token_id == token_id) { fast_dec.push(p.fp); if (++fed >= K*2) break; } }
-          auto [ok2, raw2] = fast_dec.solve();
-          if (ok2) { out = std::move(raw2); delivered = true; cout << "[SUCCESS] Early decode with " << have_after << " / " << K << " packets\n"; }
-        }
-      }
-#endif
-
-      // Decode standard
-      if(!delivered){
-#ifdef AURORA_USE_LIBRAPTORQ
-        aurora::fec::AuroraRaptorQ rq; auto dec = rq.make_decoder(bytes.size(), T); int cnt=0;
-        for(auto& p: D.buf){ if(p.token_id==token_id){ aurora::fec::EncodedSymbol s{ (uint32_t)p.fp.seed, p.fp.data }; dec->add(s); used.push_back(p.fp.data); if(++cnt > K + (int)RqRepair) break; } }
-        auto maybe = dec->decode();
-        if(maybe){ out = std::move(*maybe); delivered = true; cout << "[SUCCESS] RQ decode successful at step " << step << " with " << cnt << " symbols" << endl; }
-#else
-        fec::Decoder decod(K, T); int cnt=0;
-        for(auto& p: D.buf){ if(p.token_id==token_id){ decod.push(p.fp); used.push_back(p.fp.data); if(++cnt>K*3) break; } }
-        auto [ok, raw] = decod.solve();
-        if(ok){ out=move(raw); delivered=true; cout << "[SUCCESS] FEC decode successful at step " << step << " with " << have << " packets (needed " << K << ")" << endl; }
-#endif
+      // Decode incrementale: solo i pacchetti arrivati dall'ultimo step, solve() solo quando puo' riuscire
+      if (rx_step(D, out, &used)) {
+        delivered = true;
+        cout << "[SUCCESS] FEC decode at step " << step << " with " << have_after << " / " << K << " packets"
+             << " (" << D.rejected << " non innovativi scartati)\n";
+      } else {
+        feedback_step(step, flow_profile);
       }
 
       // Deadline check
@@ -802,7 +875,7 @@ struct Engine {
       cout<<"FAILED - aumenta RIS/epsilon o budget duty.\n";
     }
 
-    auto show=[&](const string& id){ Node& n=*net.get(id); size_t have=0; for(auto& p:n.buf) if(p.token_id==token_id) have++; cout<<" - "<<id<<" SoC="<<fixed<<setprecision(0)<<n.bat.soc()*100<<"% buf="<<have<<"\n"; };
+    auto show=[&](const string& id){ Node& n=*net.get(id); size_t have=0; for(auto& p:n.buf) if(p.token==token) have++; cout<<" - "<<id<<" SoC="<<fixed<<setprecision(0)<<n.bat.soc()*100<<"% buf="<<have<<"\n"; };
     show("SRC"); show("DST");
     cout<<"RIS="<<net.W.ris.size()<<" illum="<<net.W.illum<<"\n";
     telemetry.flush();
@@ -857,7 +930,7 @@ bool aurora_run_interactive_lab(Engine& engine, int max_steps = 5000) {
     // Usa la stessa logica di run() ma in versione continua
     for(auto& n: engine.net.nodes) n->tick(1.0), n->ingest();
 
-    int have=0; for(auto& p:D.buf) if(p.token_id==engine.token_id) have++;
+    int have=0; for(auto& p:D.buf) if(p.token==engine.token) have++;
     double e=max(0, engine.K-have)/(double)engine.K; double eres=min(1.0,max(0.0,e));
 
     // progress (meno verboso in lab mode)
@@ -941,14 +1014,14 @@ bool aurora_run_interactive_lab(Engine& engine, int max_steps = 5000) {
     opt.feedback(dec.mode, reward);
     if(emergency){ cout<<"[COVERT] EMERGENCY flag; seq="<<(int)covert_seq<<"\n"; }
 
-    int have_after = 0; for (auto& p : D.buf) if (p.token_id == engine.token_id) have_after++;
+    int have_after = 0; for (auto& p : D.buf) if (p.token == engine.token) have_after++;
     
     // Integra organismo
     aurora::FlowProfile flow_profile = engine.organism->build_profile(engine.I);
     
     vector<fec::Pkt> received_packets;
     for (auto& p : D.buf) {
-      if (p.token_id == engine.token_id) {
+      if (p.token == engine.token) {
         received_packets.push_back(p);
       }
     }
@@ -1042,13 +1115,9 @@ bool aurora_run_interactive_lab(Engine& engine, int max_steps = 5000) {
     
     engine.telemetry.record(sample);
 
-    // Early exit FEC (simplified)
-    if (have_after >= engine.K) {
-      fec::Decoder fast_dec(engine.K, engine.T); int fed = 0;
-      for (auto& p : D.buf) { if (p.token_id == engine.token_id) { fast_dec.push(p.fp); if (++fed >= engine.K*2) break; } }
-      auto [ok2, raw2] = fast_dec.solve();
-      if (ok2) { out = std::move(raw2); delivered = true; }
-    }
+    // Early exit FEC (decoder incrementale del motore)
+    if (engine.rx_step(D, out)) delivered = true;
+    else engine.feedback_step(step, flow_profile);
 
     epoch += 1.0;
 
@@ -0,0 +1,530 @@
+#pragma once
+
+// Configurazione embedded (MCU) dell'organismo: capacita' fissata a compile time dai
+// parametri template (K massimo per segmento, byte per simbolo, token in ricezione), tutti i
+// buffer dentro l'oggetto, nessuna allocazione sul heap in spawn() e integrate().
+//
+// Selezione: -DAURORA_EMBEDDED, aurora_organism.hpp include solo questo header e
+// aurora::EmbeddedOrganism usa AURORA_EMBEDDED_KMAX / _SYMBOL / _TOKENS.
+//
+// Rispetto ad AlienFountainOrganism: stesso split critico/bulk per FlowClass, stessi simboli
+// sul filo (sorgenti in chiaro poi repair LT SplitMix, decodificabili da fec::OnlineDecoder),
+// stessa memoria immunitaria con il solo genotipo BASELINE. Niente MDS, niente blocchi
+// sorgente (un segmento sta in KMAX simboli), niente streaming e niente log.
+//
+// RAM: sizeof(StaticOrganism<...>), circa TOKENS * (KMAX + CRIT_K) * (S + KMAX / 8) byte;
+// l'istanza va messa in memoria statica, non sullo stack.
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "AuroraFlowClass.hpp"
+#include "../fec/AuroraLtNeighbours.hpp"
+#include "../fec/AuroraTokenHandle.hpp"
+
+#ifndef AURORA_EMBEDDED_KMAX
+#define AURORA_EMBEDDED_KMAX 64
+#endif
+#ifndef AURORA_EMBEDDED_SYMBOL
+#define AURORA_EMBEDDED_SYMBOL 128
+#endif
+#ifndef AURORA_EMBEDDED_TOKENS
+#define AURORA_EMBEDDED_TOKENS 2
+#endif
+
+namespace aurora {
+namespace embedded {
+
+constexpr size_t CRIT_MAX_BYTES = 512;   // parte critica piu' grande (GLAND)
+
+// Stessi valori di fec::SegmentKind
+enum class SegmentKind : uint8_t { CRITICAL, BULK };
+
+// Simbolo sul filo: header fisso + S byte. payload_size e K viaggiano in ogni pacchetto,
+// il ricevitore non dipende dallo stato del mittente
+template<size_t S>
+struct StaticPkt {
+    uint32_t seed = 0;
+    uint32_t deg = 0;              // come fec::Fp::deg: grado nei 24 bit bassi, generatore negli 8 alti
+    uint32_t payload_size = 0;     // byte del payload intero (critico + bulk)
+    uint16_t K = 0;                // simboli sorgente del segmento
+    uint16_t sym = S;              // byte per simbolo
+    SegmentKind kind = SegmentKind::BULK;
+    fec::TokenHandle token = 0;    // fec::token_handle(id), come fec::Pkt
+    uint8_t data[S];
+};
+
+// dst ^= src su S byte, a parole da 8 (il compilatore vettorizza)
+template<size_t S>
+inline void xor_symbol(uint8_t* dst, const uint8_t* src) {
+    static_assert(S % 8 == 0, "embedded: S multiplo di 8");
+    for (size_t b = 0; b < S; b += 8) {
+        uint64_t x, y;
+        std::memcpy(&x, dst + b, 8);
+        std::memcpy(&y, src + b, 8);
+        x ^= y;
+        std::memcpy(dst + b, &x, 8);
+    }
+}
+
+// Eliminazione gaussiana online su GF(2) con matrice e simboli in array fissi: come
+// fec::OnlineDecoderT, riga c = pivot della colonna c, back-substitution in solve()
+template<size_t KMAX, size_t S>
+class StaticDecoder {
+public:
+    static constexpr size_t W = fec::lt_scratch_words(KMAX);
+
+    // Nuovo segmento di n <= KMAX sorgenti (false se non entra)
+    bool reset(uint32_t n) {
+        n_ = n <= KMAX ? n : 0;
+        rank_ = units_ = 0;
+        solved_ = false;
+        std::memset(has_, 0, sizeof(has_));
+        std::memset(A_, 0, (size_t)n_ * W * sizeof(uint64_t));
+        return n_ == n;
+    }
+
+    uint32_t n() const { return n_; }
+    uint32_t rank() const { return rank_; }
+    bool complete() const { return n_ > 0 && rank_ == n_; }
+
+    // true se il simbolo aumenta il rango (altrimenti e' scartato)
+    bool push(uint32_t seed, uint32_t deg, const uint8_t* data) {
+        if (solved_ || !n_) return false;
+        const uint32_t gen = deg >> 24, d = deg & fec::FP_DEG_MASK;
+        if (gen == fec::FP_GEN_SOURCE) {
+            if (!d || seed >= n_ || has_[seed]) return false;
+            A_[(size_t)seed * W + (seed >> 6)] = 1ull << (seed & 63);
+            std::memcpy(rhs_ + (size_t)seed * S, data, S);
+            has_[seed] = 1;
+            ++rank_;
+            ++units_;
+            return true;
+        }
+        std::memset(tmp_, 0, sizeof(tmp_));
+        if (!fec::for_each_lt_neighbour(seed, d, gen, n_, used_, [&](uint32_t id) { tmp_[id >> 6] ^= 1ull << (id & 63); }))
+            return false;
+        std::memcpy(tmpd_, data, S);
+        for (size_t w = 0; w < W; ++w) {
+            while (tmp_[w]) {
+                const uint32_t c = (uint32_t)(w * 64 + std::countr_zero(tmp_[w]));
+                if (!has_[c]) {
+                    std::memcpy(A_ + (size_t)c * W + w, tmp_ + w, (W - w) * sizeof(uint64_t));
+                    std::memcpy(rhs_ + (size_t)c * S, tmpd_, S);
+                    has_[c] = 1;
+                    ++rank_;
+                    return true;
+                }
+                const uint64_t* pr = A_ + (size_t)c * W;   // nessun bit sotto c nella riga pivot
+                for (size_t j = w; j < W; ++j) tmp_[j] ^= pr[j];
+                xor_symbol<S>(tmpd_, rhs_ + (size_t)c * S);
+            }
+        }
+        return false;
+    }
+
+    // A rango pieno: back-substitution in place, bytes() diventa il segmento
+    bool solve() {
+        if (!complete()) return false;
+        if (solved_ || units_ == n_) return solved_ = true;
+        for (int c = (int)n_ - 1; c >= 0; --c) {
+            uint64_t* rc = A_ + (size_t)c * W;
+            uint8_t* dc = rhs_ + (size_t)c * S;
+            rc[c >> 6] &= ~(1ull << (c & 63));
+            for (size_t w = (size_t)c >> 6; w < W; ++w)
+                for (uint64_t b = rc[w]; b; b &= b - 1) xor_symbol<S>(dc, rhs_ + (w * 64 + std::countr_zero(b)) * S);
+            std::memset(rc, 0, W * sizeof(uint64_t));
+            rc[c >> 6] = 1ull << (c & 63);
+        }
+        return solved_ = true;
+    }
+
+    // Sorgente i gia' determinato: la sua riga pivot non ha altri bit
+    bool known(uint32_t i) const {
+        if (i >= n_ || !has_[i]) return false;
+        if (solved_) return true;
+        const uint64_t* r = A_ + (size_t)i * W;
+        for (size_t w = i >> 6; w < W; ++w)
+            if (r[w] != (w == (i >> 6) ? 1ull << (i & 63) : 0)) return false;
+        return true;
+    }
+
+    // Sorgenti determinati consecutivi dal primo
+    uint32_t prefix() const {
+        uint32_t p = 0;
+        while (p < n_ && known(p)) ++p;
+        return p;
+    }
+
+    const uint8_t* bytes() const { return rhs_; }
+
+private:
+    uint32_t n_ = 0, rank_ = 0, units_ = 0;   // units: righe pivot = sorgente puro
+    bool solved_ = false;
+    alignas(64) uint8_t rhs_[KMAX * S];
+    alignas(64) uint8_t tmpd_[S];
+    uint64_t A_[KMAX * W];
+    uint64_t tmp_[W];
+    uint64_t used_[W];   // scratch del generatore dei neighbour
+    uint8_t has_[KMAX];
+};
+
+struct StaticIntegrateResult {
+    bool delivered = false;
+    double coverage = 0.0;          // 0..1, frazione di byte del payload gia' ricostruiti
+    int symbols_used = 0;
+    int total_symbols_seen = 0;
+    size_t payload_size = 0;        // byte del payload intero (dai pacchetti)
+    size_t payload_len = 0;         // byte contigui scritti in out (payload intero se delivered)
+};
+
+// Memoria immunitaria per FlowClass, come aurora::FlowState (genotipo BASELINE)
+struct StaticFlowState {
+    double crit_overhead = 1.0;
+    double bulk_overhead = 1.0;
+    double base_crit_overhead = 1.0;
+    double base_bulk_overhead = 1.0;
+    double avg_coverage = 0.0;
+    int success_count = 0;
+    int fail_count = 0;
+    int panic_boost = 0;
+    int good_streak = 0;
+    int bad_streak = 0;
+};
+
+template<size_t KMAX, size_t S, size_t TOKENS>
+class StaticOrganism {
+public:
+    static_assert(KMAX > 0 && KMAX <= 0xFFFF, "embedded: KMAX in [1, 65535]");
+    static_assert(S >= 8 && S <= 0xFFFF, "embedded: S in [8, 65535]");
+    static_assert(TOKENS > 0, "embedded: almeno un token in ricezione");
+
+    using Pkt = StaticPkt<S>;
+    static constexpr size_t MAX_PAYLOAD = KMAX * S;
+    static constexpr size_t CRIT_K = (CRIT_MAX_BYTES + S - 1) / S < KMAX ? (CRIT_MAX_BYTES + S - 1) / S : KMAX;
+
+    // Parametri BASELINE (cl::InteractiveConfig di default)
+    static constexpr double ALPHA_UP = 0.10;
+    static constexpr double ALPHA_DOWN = 0.02;
+    static constexpr int PANIC_BOOST_STEPS = 3;
+    static constexpr double MAX_OVERHEAD = 4.0;
+
+    explicit StaticOrganism(uint32_t seed = 1) : rng_(seed) {
+        for (size_t c = 0; c < 3; ++c) {
+            StaticFlowState& st = flows_[c];
+            st.base_crit_overhead = st.crit_overhead = crit_overhead_factor((FlowClass)c);
+            st.base_bulk_overhead = st.bulk_overhead = bulk_overhead_factor((FlowClass)c);
+        }
+    }
+
+    // Byte della parte critica (tutto il payload se non si segmenta), come AlienFountainOrganism
+    static size_t critical_size_for(FlowClass cls, size_t payload_size) {
+        size_t c = cls == FlowClass::NERVE ? 256 : cls == FlowClass::GLAND ? 512 : 128;
+        if (c > payload_size) c = payload_size;
+        return (c > 0 && c < payload_size) ? c : payload_size;
+    }
+
+    // Pacchetti che spawn() emetterebbe adesso per len byte (0 se il payload non entra)
+    size_t spawn_count(FlowClass cls, size_t len) const {
+        Plan pl;
+        return plan(cls, len, pl) ? pl.n_crit + pl.n_bulk : 0;
+    }
+
+    // Simboli del payload in out[0..cap): sorgenti critici, repair critici, sorgenti bulk, repair bulk.
+    // Ritorna quanti ne ha scritti: 0 se il payload non entra o cap non basta per i sorgenti
+    // (i repair oltre cap vengono tagliati)
+    size_t spawn(FlowClass cls, const char* token_id, const uint8_t* payload, size_t len, Pkt* out, size_t cap) {
+        Plan pl;
+        if (!plan(cls, len, pl) || cap < (size_t)pl.K_crit + pl.K_bulk) return 0;
+        const fec::TokenHandle token = fec::token_handle(token_id);
+        StaticFlowState& st = flows_[(size_t)cls];
+        if (st.panic_boost > 0) st.panic_boost -= 1;
+
+        size_t at = 0;
+        auto segment = [&](SegmentKind kind, const uint8_t* seg, size_t bytes, uint32_t K, size_t n) {
+            if (!K) return;
+            fill_cdf(K);
+            for (size_t i = 0; i < n && at < cap; ++i) {
+                Pkt& p = out[at++];
+                p.payload_size = (uint32_t)len;
+                p.K = (uint16_t)K;
+                p.sym = (uint16_t)S;
+                p.kind = kind;
+                p.token = token;
+                if (i < K) {
+                    p.seed = (uint32_t)i;
+                    p.deg = 1u | fec::FP_GEN_SOURCE << 24;
+                    load_source(p.data, seg, bytes, (uint32_t)i);
+                    continue;
+                }
+                const uint32_t d = draw_degree(K);
+                p.seed = (uint32_t)(rng_.next() >> 32);
+                p.deg = d | fec::FP_GEN_SPLITMIX << 24;
+                std::memset(p.data, 0, S);
+                fec::for_each_lt_neighbour(p.seed, d, fec::FP_GEN_SPLITMIX, K, used_,
+                                           [&](uint32_t id) { xor_source(p.data, seg, bytes, id); });
+            }
+        };
+        segment(SegmentKind::CRITICAL, payload, pl.crit_bytes, pl.K_crit, pl.n_crit);
+        segment(SegmentKind::BULK, payload + pl.crit_bytes, len - pl.crit_bytes, pl.K_bulk, pl.n_bulk);
+        return at;
+    }
+
+    // Integra i pacchetti ricevuti per token_id: pkts[0..n) e' trattato come append-only
+    // (si consumano solo quelli nuovi; se n cala si riparte). Con out != nullptr (MAX_PAYLOAD
+    // byte) vi scrive il payload, o il suo prefisso contiguo gia' ricostruito
+    StaticIntegrateResult integrate(FlowClass cls, const char* token_id, const Pkt* pkts, size_t n, uint8_t* out = nullptr) {
+        StaticIntegrateResult result;
+        const fec::TokenHandle token = fec::token_handle(token_id);
+        Slot& rx = slot_for(token);
+        if (n < rx.fed) open(rx, token);
+
+        for (; rx.fed < n; ++rx.fed) {
+            const Pkt& p = pkts[rx.fed];
+            if (p.token != token || p.sym != S) continue;
+            if (!rx.payload_size && !setup(rx, cls, p.payload_size)) continue;
+            if (p.payload_size != rx.payload_size) continue;
+            rx.seen++;
+            if (p.kind == SegmentKind::CRITICAL) {
+                if (p.K == rx.crit.n() && !rx.crit_ok && rx.crit.push(p.seed, p.deg, p.data)) rx.used_crit++;
+            } else {
+                if (p.K == rx.bulk.n() && !rx.bulk_ok && rx.bulk.push(p.seed, p.deg, p.data)) rx.used_bulk++;
+            }
+        }
+        result.total_symbols_seen = rx.seen;
+        result.payload_size = rx.payload_size;
+        if (rx.seen == 0) return result;
+
+        if (!rx.crit_ok && rx.crit.n()) rx.crit_ok = rx.crit.solve();
+        if (!rx.bulk_ok && rx.bulk.n()) rx.bulk_ok = rx.bulk.solve();
+        result.symbols_used = rx.used_crit + rx.used_bulk;
+
+        const size_t bulk_bytes = rx.payload_size - rx.crit_bytes;
+        const size_t covered = known_bytes(rx.crit, rx.crit_bytes) + known_bytes(rx.bulk, bulk_bytes);
+        result.coverage = rx.payload_size ? (double)covered / (double)rx.payload_size : 0.0;
+        if (result.coverage > 1.0) result.coverage = 1.0;
+
+        // Critico (intero o prefisso noto) e, solo a critico completo, il prefisso del bulk
+        const size_t crit_len = prefix_bytes(rx.crit, rx.crit_bytes);
+        result.payload_len = crit_len;
+        if (crit_len == rx.crit_bytes) result.payload_len += prefix_bytes(rx.bulk, bulk_bytes);
+        if (out) {
+            std::memcpy(out, rx.crit.bytes(), crit_len);
+            if (result.payload_len > crit_len) std::memcpy(out + crit_len, rx.bulk.bytes(), result.payload_len - crit_len);
+        }
+        result.delivered = result.coverage >= 1.0;
+
+        // Token completato: lo slot torna libero
+        if (result.delivered) rx.used = false;
+
+        update_flow_state(cls, flows_[(size_t)cls], result.coverage, result.delivered,
+                          result.symbols_used, result.total_symbols_seen);
+        return result;
+    }
+
+    const StaticFlowState& flow_state(FlowClass cls) const { return flows_[(size_t)cls]; }
+
+    // Token in ricezione con uno slot occupato
+    size_t active_tokens() const {
+        size_t a = 0;
+        for (const Slot& s : slots_) a += s.used;
+        return a;
+    }
+
+private:
+    struct Plan {
+        size_t crit_bytes = 0;
+        uint32_t K_crit = 0, K_bulk = 0;
+        size_t n_crit = 0, n_bulk = 0;
+    };
+
+    // Decoder per token: critico al piu' CRIT_K simboli, bulk al piu' KMAX
+    struct Slot {
+        bool used = false;
+        fec::TokenHandle token = 0;
+        uint32_t stamp = 0;           // ultimo uso, per liberare lo slot piu' vecchio
+        size_t fed = 0;
+        uint32_t payload_size = 0;    // 0 = geometria non ancora nota
+        size_t crit_bytes = 0;
+        int seen = 0, used_crit = 0, used_bulk = 0;
+        bool crit_ok = false, bulk_ok = false;
+        StaticDecoder<CRIT_K, S> crit;
+        StaticDecoder<KMAX, S> bulk;
+    };
+
+    static double crit_overhead_factor(FlowClass cls) { return cls == FlowClass::MUSCLE ? 1.25 : 2.0; }
+    static double bulk_overhead_factor(FlowClass cls) {
+        return cls == FlowClass::NERVE ? 1.0 : cls == FlowClass::GLAND ? 1.5 : 1.2;
+    }
+
+    bool plan(FlowClass cls, size_t len, Plan& pl) const {
+        if (!len || len > MAX_PAYLOAD) return false;
+        pl.crit_bytes = critical_size_for(cls, len);
+        pl.K_crit = (uint32_t)((pl.crit_bytes + S - 1) / S);
+        pl.K_bulk = (uint32_t)((len - pl.crit_bytes + S - 1) / S);
+        if (pl.K_crit > CRIT_K) return false;
+        const StaticFlowState& st = flows_[(size_t)cls];
+        double crit_ov = st.crit_overhead, bulk_ov = st.bulk_overhead;
+        if (st.panic_boost > 0) {
+            crit_ov *= 2.0;
+            bulk_ov *= 1.5;
+        }
+        auto count = [](uint32_t K, double ov) {
+            size_t c = (size_t)std::ceil(K * ov);
+            return c < K ? (size_t)K : c;
+        };
+        pl.n_crit = count(pl.K_crit, crit_ov);
+        pl.n_bulk = count(pl.K_bulk, bulk_ov);
+        return true;
+    }
+
+    // Robust Soliton come fec::robust_soliton_cdf (c = 0.1, delta = 0.05), in cdf_[0..K)
+    void fill_cdf(uint32_t k) {
+        if (k <= 1) { cdf_[0] = 1.0f; return; }
+        const double c = 0.1, delta = 0.05;
+        double R = c * std::log(k / delta) * std::sqrt((double)k);
+        if (R < 1.0) R = 1.0;
+        int spike = (int)std::floor(k / R);
+        spike = spike < 1 ? 1 : spike > (int)k ? (int)k : spike;
+        double z = 0;
+        for (int i = 1; i <= (int)k; ++i) {
+            double rho = i == 1 ? 1.0 / k : 1.0 / ((double)i * (i - 1));
+            double tau = i < spike ? R / ((double)i * k) : i == spike ? R * std::log(R / delta) / k : 0.0;
+            z += rho + (tau > 0 ? tau : 0.0);
+            cdf_[i - 1] = (float)z;
+        }
+        for (uint32_t i = 0; i < k; ++i) cdf_[i] = (float)(cdf_[i] / z);
+        cdf_[k - 1] = 1.0f;
+    }
+
+    uint32_t draw_degree(uint32_t k) {
+        const float u = (float)(rng_.next() >> 40) * (1.0f / 16777216.0f);
+        uint32_t lo = 0, hi = k - 1;
+        while (lo < hi) {
+            uint32_t mid = (lo + hi) / 2;
+            if (cdf_[mid] < u) lo = mid + 1; else hi = mid;
+        }
+        return lo + 1;
+    }
+
+    static void load_source(uint8_t* dst, const uint8_t* seg, size_t bytes, uint32_t i) {
+        const size_t off = (size_t)i * S, m = bytes - off < S ? bytes - off : S;
+        std::memcpy(dst, seg + off, m);
+        std::memset(dst + m, 0, S - m);
+    }
+
+    // L'ultimo sorgente del segmento e' corto: il resto vale zero
+    static void xor_source(uint8_t* dst, const uint8_t* seg, size_t bytes, uint32_t i) {
+        const size_t off = (size_t)i * S;
+        if (bytes - off >= S) { xor_symbol<S>(dst, seg + off); return; }
+        for (size_t b = 0; off + b < bytes; ++b) dst[b] ^= seg[off + b];
+    }
+
+    template<size_t K>
+    static size_t known_bytes(const StaticDecoder<K, S>& d, size_t bytes) {
+        size_t k = 0;
+        for (uint32_t i = 0; i < d.n(); ++i)
+            if (d.known(i)) k += bytes - (size_t)i * S < S ? bytes - (size_t)i * S : S;
+        return k;
+    }
+
+    template<size_t K>
+    static size_t prefix_bytes(const StaticDecoder<K, S>& d, size_t bytes) {
+        const size_t p = (size_t)d.prefix() * S;
+        return p < bytes ? p : bytes;
+    }
+
+    void open(Slot& s, fec::TokenHandle token) {
+        s.used = true;
+        s.token = token;
+        s.fed = 0;
+        s.payload_size = 0;
+        s.crit_bytes = 0;
+        s.seen = s.used_crit = s.used_bulk = 0;
+        s.crit_ok = s.bulk_ok = false;
+        s.crit.reset(0);
+        s.bulk.reset(0);
+    }
+
+    // Geometria del token dal primo pacchetto valido
+    bool setup(Slot& s, FlowClass cls, uint32_t payload_size) {
+        Plan pl;
+        if (!plan(cls, payload_size, pl)) return false;
+        s.payload_size = payload_size;
+        s.crit_bytes = pl.crit_bytes;
+        s.crit.reset(pl.K_crit);
+        s.bulk.reset(pl.K_bulk);
+        s.crit_ok = pl.K_crit == 0;
+        s.bulk_ok = pl.K_bulk == 0;
+        return true;
+    }
+
+    // Slot del token, altrimenti uno libero o quello usato meno di recente
+    Slot& slot_for(fec::TokenHandle token) {
+        Slot* victim = &slots_[0];
+        for (Slot& s : slots_) {
+            if (s.used && s.token == token) { s.stamp = ++clock_; return s; }
+            if (!s.used) { if (victim->used) victim = &s; }
+            else if (victim->used && s.stamp < victim->stamp) victim = &s;
+        }
+        open(*victim, token);
+        victim->stamp = ++clock_;
+        return *victim;
+    }
+
+    // Aggiorna stato adattivo come AlienFountainOrganism::update_flow_state (BASELINE)
+    void update_flow_state(FlowClass cls, StaticFlowState& st, double coverage, bool delivered,
+                           int symbols_used, int total_symbols_seen) {
+        const double alpha_cov = 0.2;
+        st.avg_coverage = st.success_count + st.fail_count == 0
+            ? coverage : alpha_cov * coverage + (1.0 - alpha_cov) * st.avg_coverage;
+        if (delivered) {
+            st.success_count++;
+            st.good_streak++;
+            st.bad_streak = 0;
+        } else {
+            st.fail_count++;
+            st.bad_streak++;
+            st.good_streak = 0;
+            st.crit_overhead += ALPHA_UP;
+            st.bulk_overhead += ALPHA_UP * 0.5;
+            if (cls == FlowClass::NERVE || cls == FlowClass::GLAND) {
+                if (st.panic_boost < PANIC_BOOST_STEPS) st.panic_boost = PANIC_BOOST_STEPS;
+                st.crit_overhead += ALPHA_UP;
+                if (st.bad_streak >= 3) {
+                    st.crit_overhead += ALPHA_UP * 0.5;
+                    st.bulk_overhead += ALPHA_UP * 0.5;
+                }
+            }
+        }
+        if (delivered && total_symbols_seen > 0 && (double)symbols_used / total_symbols_seen < 0.5) {
+            st.crit_overhead -= ALPHA_DOWN;
+            st.bulk_overhead -= ALPHA_DOWN;
+        }
+        if (delivered && st.panic_boost == 0 && st.good_streak >= 4 && st.avg_coverage >= 0.85) {
+            const double delta = cls == FlowClass::MUSCLE ? ALPHA_DOWN * 1.5 : ALPHA_DOWN;
+            st.crit_overhead -= delta;
+            st.bulk_overhead -= delta;
+        }
+        auto clamp = [](double v, double lo, double hi) { return v < lo ? lo : v > hi ? hi : v; };
+        st.crit_overhead = clamp(st.crit_overhead, st.base_crit_overhead, MAX_OVERHEAD);
+        st.bulk_overhead = clamp(st.bulk_overhead, st.base_bulk_overhead, MAX_OVERHEAD);
+    }
+
+    StaticFlowState flows_[3];
+    Slot slots_[TOKENS];
+    uint32_t clock_ = 0;
+    fec::SplitMix rng_;
+    float cdf_[KMAX];
+    uint64_t used_[fec::lt_scratch_words(KMAX)];   // scratch del generatore dei neighbour
+};
+
+} // namespace embedded
+
+// Configurazione scelta da AURORA_EMBEDDED_KMAX / _SYMBOL / _TOKENS
+using EmbeddedOrganism = embedded::StaticOrganism<AURORA_EMBEDDED_KMAX, AURORA_EMBEDDED_SYMBOL, AURORA_EMBEDDED_TOKENS>;
+
+} // namespace aurora
@@ -0,0 +1,48 @@
+#pragma once
+
+// Classe di flusso condivisa dall'organismo completo (aurora_organism.hpp) e dalla
+// configurazione embedded (AuroraEmbeddedOrganism.hpp), con la priorita' del profilo: enum
+// piccole, usate come indici della tabella degli stati adattivi
+
+#include <cstddef>
+#include <cstdint>
+
+namespace aurora {
+
+// Classificazione biologica del flusso: tipo di tessuto di trasporto
+enum class FlowClass : uint8_t {
+    NERVE,   // latenza critica, payload piccolo, alta priorità
+    MUSCLE,  // bulk data, throughput importante, può tollerare ritardi
+    GLAND    // eventi rari, altissima affidabilità, meno sensibili alla latenza
+};
+
+// Priorita' del flusso, derivata dalla reliability richiesta (build_profile)
+enum class Priority : uint8_t {
+    CRITICAL,  // reliability >= 0.99
+    NORMAL,    // reliability >= 0.90
+    BULK       // il resto
+};
+
+// Numero di valori delle due enum: dimensioni delle tabelle indicizzate per (classe, priorita')
+constexpr size_t FLOW_CLASS_COUNT = 3;
+constexpr size_t PRIORITY_COUNT = 3;
+
+inline const char* flow_class_name(FlowClass c) {
+    switch (c) {
+        case FlowClass::NERVE:  return "NERVE";
+        case FlowClass::GLAND:  return "GLAND";
+        case FlowClass::MUSCLE: return "MUSCLE";
+    }
+    return "?";
+}
+
+inline const char* priority_name(Priority p) {
+    switch (p) {
+        case Priority::CRITICAL: return "CRITICAL";
+        case Priority::NORMAL:   return "NORMAL";
+        case Priority::BULK:     return "BULK";
+    }
+    return "?";
+}
+
+} // namespace aurora
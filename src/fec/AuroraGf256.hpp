@@ -0,0 +1,197 @@
+#pragma once
+
+// Aritmetica GF(256) con polinomio 0x11D (lo stesso di RaptorQ), condivisa dai codec
+// non binari: core HDPC di aurora::fec::AuroraRaptorQ, fec::SlidingWindow* e il codice
+// MDS dei segmenti piccoli (fec::MdsDecoder).
+//
+// Moltiplicazione di interi simboli per una costante c con tabelle split-nibble:
+// c*x = T_lo[x & 15] ^ T_hi[x >> 4], due tabelle da 16 byte che stanno in un registro
+// e si consultano con PSHUFB (SSSE3/AVX2) o TBL (NEON). Varianti scelte a runtime come
+// i kernel XOR; c == 1 ricade direttamente sul kernel XOR.
+//
+// Override per test/benchmark: AURORA_GF_KERNEL=portable|ssse3|avx2|neon
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "AuroraXorKernels.hpp"
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+  #define AURORA_GF_NEON 1
+  #include <arm_neon.h>
+#endif
+
+namespace fec {
+namespace simd {
+
+// tab: 32 byte, tab[i] = c * i, tab[16 + i] = c * (i << 4).
+// ACC = true: dst ^= c * src, ACC = false: dst = c * src (dst == src ammesso)
+using GfMulFn = void (*)(uint8_t* dst, const uint8_t* src, const uint8_t* tab, size_t n);
+
+template<bool ACC>
+inline void gf_mul_portable(uint8_t* dst, const uint8_t* src, const uint8_t* tab, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        uint8_t p = tab[src[i] & 15] ^ tab[16 + (src[i] >> 4)];
+        dst[i] = ACC ? dst[i] ^ p : p;
+    }
+}
+
+#ifdef AURORA_XOR_X86
+template<bool ACC>
+AURORA_TARGET("ssse3")
+inline void gf_mul_ssse3(uint8_t* dst, const uint8_t* src, const uint8_t* tab, size_t n) {
+    const __m128i lo = _mm_loadu_si128((const __m128i*)tab);
+    const __m128i hi = _mm_loadu_si128((const __m128i*)(tab + 16));
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    size_t b = 0;
+    for (; b + 16 <= n; b += 16) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + b));
+        __m128i p = _mm_xor_si128(_mm_shuffle_epi8(lo, _mm_and_si128(s, mask)),
+                                  _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi64(s, 4), mask)));
+        if (ACC) p = _mm_xor_si128(p, _mm_loadu_si128((const __m128i*)(dst + b)));
+        _mm_storeu_si128((__m128i*)(dst + b), p);
+    }
+    gf_mul_portable<ACC>(dst + b, src + b, tab, n - b);
+}
+
+template<bool ACC>
+AURORA_TARGET("avx2")
+inline void gf_mul_avx2(uint8_t* dst, const uint8_t* src, const uint8_t* tab, size_t n) {
+    const __m256i lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)tab));
+    const __m256i hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(tab + 16)));
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    size_t b = 0;
+    for (; b + 64 <= n; b += 64) {
+        __m256i s0 = _mm256_loadu_si256((const __m256i*)(src + b));
+        __m256i s1 = _mm256_loadu_si256((const __m256i*)(src + b + 32));
+        __m256i p0 = _mm256_xor_si256(_mm256_shuffle_epi8(lo, _mm256_and_si256(s0, mask)),
+                                      _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi64(s0, 4), mask)));
+        __m256i p1 = _mm256_xor_si256(_mm256_shuffle_epi8(lo, _mm256_and_si256(s1, mask)),
+                                      _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi64(s1, 4), mask)));
+        if (ACC) {
+            p0 = _mm256_xor_si256(p0, _mm256_loadu_si256((const __m256i*)(dst + b)));
+            p1 = _mm256_xor_si256(p1, _mm256_loadu_si256((const __m256i*)(dst + b + 32)));
+        }
+        _mm256_storeu_si256((__m256i*)(dst + b), p0);
+        _mm256_storeu_si256((__m256i*)(dst + b + 32), p1);
+    }
+    gf_mul_ssse3<ACC>(dst + b, src + b, tab, n - b);
+}
+
+inline bool cpu_has_ssse3() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int r[4];
+    __cpuid(r, 1);
+    return (r[2] >> 9) & 1;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3");
+#endif
+}
+#endif // AURORA_XOR_X86
+
+#ifdef AURORA_GF_NEON
+template<bool ACC>
+inline void gf_mul_neon(uint8_t* dst, const uint8_t* src, const uint8_t* tab, size_t n) {
+    const uint8x16_t lo = vld1q_u8(tab);
+    const uint8x16_t hi = vld1q_u8(tab + 16);
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+    size_t b = 0;
+    for (; b + 16 <= n; b += 16) {
+        uint8x16_t s = vld1q_u8(src + b);
+        uint8x16_t p = veorq_u8(vqtbl1q_u8(lo, vandq_u8(s, mask)), vqtbl1q_u8(hi, vshrq_n_u8(s, 4)));
+        if (ACC) p = veorq_u8(p, vld1q_u8(dst + b));
+        vst1q_u8(dst + b, p);
+    }
+    gf_mul_portable<ACC>(dst + b, src + b, tab, n - b);
+}
+#endif
+
+struct GfKernel {
+    const char* name;
+    GfMulFn mul_add;   // dst ^= c * src
+    GfMulFn mul;       // dst  = c * src
+    bool supported;
+};
+
+// Tutte le varianti compilate, dalla piu' semplice alla piu' larga
+inline const std::vector<GfKernel>& gf_kernels() {
+    static const std::vector<GfKernel> ks = [] {
+        std::vector<GfKernel> v;
+        v.push_back({"portable", &gf_mul_portable<true>, &gf_mul_portable<false>, true});
+#ifdef AURORA_XOR_X86
+        v.push_back({"ssse3", &gf_mul_ssse3<true>, &gf_mul_ssse3<false>, cpu_has_ssse3()});
+        v.push_back({"avx2", &gf_mul_avx2<true>, &gf_mul_avx2<false>, cpu_has(CpuFeature::AVX2)});
+#endif
+#ifdef AURORA_GF_NEON
+        v.push_back({"neon", &gf_mul_neon<true>, &gf_mul_neon<false>, true});
+#endif
+        return v;
+    }();
+    return ks;
+}
+
+// Variante piu' larga supportata (o quella forzata da AURORA_GF_KERNEL)
+inline const GfKernel& gf_selected() {
+    static const GfKernel* sel = [] {
+        const auto& ks = gf_kernels();
+        const GfKernel* best = &ks.front();
+        for (const auto& k : ks) if (k.supported) best = &k;
+        const char* env = std::getenv("AURORA_GF_KERNEL");
+        if (env && *env) {
+            for (const auto& k : ks) if (k.supported && std::string(env) == k.name) best = &k;
+        }
+        return best;
+    }();
+    return *sel;
+}
+
+} // namespace simd
+
+struct Gf256 {
+    uint8_t exp[512], log[256];
+    uint8_t nib[256][32];   // tabelle split-nibble per ogni costante
+    Gf256() {
+        uint32_t x = 1;
+        for (int i = 0; i < 255; ++i) {
+            exp[i] = exp[i + 255] = (uint8_t)x;
+            log[x] = (uint8_t)i;
+            x <<= 1;
+            if (x & 0x100) x ^= 0x11D;
+        }
+        exp[510] = exp[511] = 0;
+        log[0] = 0;
+        for (int c = 0; c < 256; ++c)
+            for (int i = 0; i < 16; ++i) {
+                nib[c][i] = mul((uint8_t)c, (uint8_t)i);
+                nib[c][16 + i] = mul((uint8_t)c, (uint8_t)(i << 4));
+            }
+    }
+    uint8_t mul(uint8_t a, uint8_t b) const { return (a && b) ? exp[log[a] + log[b]] : 0; }
+    uint8_t inv(uint8_t a) const { return exp[255 - log[a]]; }
+    // dst ^= c * src
+    void mul_add(uint8_t* dst, const uint8_t* src, uint8_t c, size_t n) const {
+        if (!c) return;
+        if (c == 1) { simd::xor_into(dst, src, n); return; }
+        static const simd::GfMulFn fn = simd::gf_selected().mul_add;
+        fn(dst, src, nib[c], n);
+    }
+    // dst = c * src
+    void mul_into(uint8_t* dst, const uint8_t* src, uint8_t c, size_t n) const {
+        if (c == 1) { if (dst != src) std::memmove(dst, src, n); return; }
+        static const simd::GfMulFn fn = simd::gf_selected().mul;
+        fn(dst, src, nib[c], n);
+    }
+    void scale(uint8_t* d, uint8_t c, size_t n) const { mul_into(d, d, c, n); }
+};
+
+inline const Gf256& gf256() {
+    static const Gf256 g;
+    return g;
+}
+
+} // namespace fec
@@ -0,0 +1,69 @@
+#pragma once
+
+// Generatore dei neighbour dei simboli LT, condiviso dal codec completo (aurora_extreme.hpp)
+// e dalla configurazione embedded (src/core/AuroraEmbeddedOrganism.hpp): stessi indici per
+// lo stesso (seed, grado, versione), quindi i due lati si parlano.
+//
+// Niente allocazioni: la bitmap per gli estratti oltre 32 e' un buffer del chiamante.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fec {
+
+// Versione del generatore dei neighbour negli 8 bit alti di Fp.deg (24 bit di grado):
+// 0 = mt19937 storico, 1 = SplitMix64, 2 = simbolo sorgente (modo sistematico, seed = indice),
+// 3 = repair MDS in GF(256) (seed = ESI, solo MdsDecoder). Simboli vecchi e nuovi convivono
+// nello stesso decoder.
+enum : uint32_t { FP_GEN_MT19937 = 0, FP_GEN_SPLITMIX = 1, FP_GEN_SOURCE = 2, FP_GEN_MDS = 3 };
+constexpr uint32_t FP_DEG_MASK = 0x00FFFFFFu;
+
+// SplitMix64 a contatore: stato = un uint64, l'i-esimo valore dipende solo da (seed, i)
+struct SplitMix {
+    uint64_t s;
+    explicit SplitMix(uint32_t seed) : s((uint64_t)seed * 0xD1B54A32D192ED03ULL) {}
+    uint64_t next() {
+        uint64_t z = (s += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+    uint32_t below(uint32_t n) { return (uint32_t)(((next() >> 32) * (uint64_t)n) >> 32); }  // multiply-shift, niente modulo
+};
+
+// Parole della bitmap di scratch per n sorgenti
+constexpr size_t lt_scratch_words(size_t n) { return (n + 63) / 64; }
+
+// Neighbour di un simbolo SplitMix o sorgente (altre versioni: nessun indice, ritorna false).
+// SplitMix estrae indici distinti con l'algoritmo di Floyd; oltre 32 estratti i duplicati si
+// cercano in `used`, lt_scratch_words(n) parole che vengono azzerate qui.
+template<typename F>
+inline bool for_each_lt_neighbour(uint32_t seed, uint32_t deg, uint32_t gen, uint32_t n, uint64_t* used, F&& f) {
+    if (gen == FP_GEN_SOURCE) {
+        if (deg && seed < n) f(seed);
+        return true;
+    }
+    if (gen != FP_GEN_SPLITMIX) return false;
+    SplitMix g(seed);
+    const uint32_t d = deg < n ? deg : n;
+    if (d <= 32) {
+        uint32_t pick[32];
+        for (uint32_t j = n - d, c = 0; j < n; ++j, ++c) {
+            uint32_t t = g.below(j + 1);
+            for (uint32_t q = 0; q < c; ++q) if (pick[q] == t) { t = j; break; }
+            pick[c] = t;
+            f(t);
+        }
+        return true;
+    }
+    for (size_t w = 0; w < lt_scratch_words(n); ++w) used[w] = 0;
+    for (uint32_t j = n - d; j < n; ++j) {
+        uint32_t t = g.below(j + 1);
+        if (used[t >> 6] >> (t & 63) & 1) t = j;
+        used[t >> 6] |= 1ull << (t & 63);
+        f(t);
+    }
+    return true;
+}
+
+} // namespace fec
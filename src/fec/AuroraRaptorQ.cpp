@@ -0,0 +1,427 @@
+// AuroraRaptorQ.cpp
+// Codec fountain RaptorQ-style interno: precode LDPC/HDPC + LT esterno, decodifica
+// con peeling/inattivazione in GF(2) e core denso in GF(256).
+
+#include "fec/AuroraRaptorQ.hpp"
+#include "aurora_extreme.hpp"
+#include "fec/AuroraGf256.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace aurora {
+namespace fec {
+
+namespace {
+
+using Rows = std::vector<std::vector<uint32_t>>;
+
+bool is_prime(uint32_t n) {
+    if (n < 2) return false;
+    for (uint32_t d = 2; (uint64_t)d * d <= n; ++d)
+        if (n % d == 0) return false;
+    return true;
+}
+
+uint32_t next_prime(uint32_t n) {
+    while (!is_prime(n)) ++n;
+    return n;
+}
+
+uint64_t choose(uint32_t n, uint32_t k) {
+    uint64_t r = 1;
+    for (uint32_t i = 1; i <= k; ++i) r = r * (n - k + i) / i;
+    return r;
+}
+
+// Distribuzione dei gradi R10 (RFC 5053, 5.4.4.2): soglie su 20 bit
+uint32_t r10_degree(uint32_t v) {
+    static const uint32_t f[] = {10241, 491582, 712794, 831695, 948446, 1032189, 1048576};
+    static const uint32_t d[] = {1, 2, 3, 4, 10, 11, 40};
+    for (int j = 0; j < 7; ++j)
+        if (v < f[j]) return d[j];
+    return 40;
+}
+
+// Le colonne di una riga devono essere distinte: le coppie si annullano in GF(2)
+void cancel_pairs(std::vector<uint32_t>& r) {
+    std::sort(r.begin(), r.end());
+    size_t w = 0;
+    for (size_t i = 0; i < r.size();) {
+        size_t j = i;
+        while (j < r.size() && r[j] == r[i]) ++j;
+        if ((j - i) & 1) r[w++] = r[i];
+        i = j;
+    }
+    r.resize(w);
+}
+
+using ::fec::Gf256;
+
+const Gf256& gf() { return ::fec::gf256(); }
+
+// Risolve gli L simboli intermedi. rows sono le righe GF(2) (LDPC + LT) con termini
+// noti da T byte, i vincoli HDPC vengono da p.hdpc. Stessa struttura di
+// fec::PeelingDecoder: peeling sugli indici, inattivazione quando si blocca, XOR
+// registrate e applicate ai dati solo alla fine; qui pero' il core delle colonne
+// inattive riceve anche le righe HDPC ed e' risolto in GF(256).
+std::optional<std::vector<uint8_t>> solve_intermediate(const RqParams& p, size_t T, const Rows& rows,
+                                                       const std::vector<const uint8_t*>& rhs) {
+    const uint32_t n = p.L;
+    const int m = (int)rows.size();
+    if ((uint32_t)m + p.H < n) return std::nullopt;
+
+    enum : uint8_t { ACTIVE, RESOLVED, INACTIVE };
+    std::vector<uint8_t> st(n, ACTIVE), used(m, 0);
+    std::vector<int> pivot(n, -1), inact_idx(n, -1), deg(m);
+    std::vector<std::vector<uint64_t>> mask(m);
+    std::vector<std::vector<int>> rows_of(n);
+    for (int r = 0; r < m; ++r) {
+        deg[r] = (int)rows[r].size();
+        for (uint32_t c : rows[r]) rows_of[c].push_back(r);
+    }
+    std::vector<std::pair<int, int>> ops;   // (dst, src): R[dst] ^= R[src]
+    std::vector<int> q;
+    for (int r = 0; r < m; ++r)
+        if (deg[r] == 1) q.push_back(r);
+    int left = (int)n, n_inact = 0;
+
+    auto mask_xor = [&](int dst, int src) {
+        auto& d = mask[dst];
+        const auto& s2 = mask[src];
+        if (d.size() < s2.size()) d.resize(s2.size(), 0);
+        for (size_t i = 0; i < s2.size(); ++i) d[i] ^= s2[i];
+    };
+    auto inactivate = [&](uint32_t c) {
+        st[c] = INACTIVE;
+        int b = inact_idx[c] = n_inact++;
+        --left;
+        for (int r : rows_of[c]) {
+            if (used[r]) continue;
+            auto& v = mask[r];
+            if (v.size() <= (size_t)(b >> 6)) v.resize((b >> 6) + 1, 0);
+            v[b >> 6] |= 1ull << (b & 63);
+            if (--deg[r] == 1) q.push_back(r);
+        }
+    };
+
+    for (uint32_t c = p.W; c < n; ++c) inactivate(c);   // PI: inattivi da subito
+    while (left > 0) {
+        if (q.empty()) {
+            int best = -1;
+            for (int r = 0; r < m; ++r)
+                if (!used[r] && deg[r] >= 2 && (best < 0 || deg[r] < deg[best])) best = r;
+            if (best < 0) {
+                // righe GF(2) esaurite: il resto lo devono coprire i vincoli HDPC
+                for (uint32_t c = 0; c < n; ++c)
+                    if (st[c] == ACTIVE) inactivate(c);
+                break;
+            }
+            bool keep = true;
+            for (uint32_t c : rows[best]) {
+                if (st[c] != ACTIVE) continue;
+                if (keep) { keep = false; continue; }
+                inactivate(c);
+            }
+            continue;
+        }
+        int r = q.back();
+        q.pop_back();
+        if (used[r] || deg[r] != 1) continue;
+        uint32_t c = 0;
+        for (uint32_t x : rows[r])
+            if (st[x] == ACTIVE) { c = x; break; }
+        used[r] = 1;
+        st[c] = RESOLVED;
+        pivot[c] = r;
+        --left;
+        for (int r2 : rows_of[c]) {
+            if (r2 == r || used[r2]) continue;
+            ops.push_back({r2, r});
+            mask_xor(r2, r);
+            if (--deg[r2] == 1) q.push_back(r2);
+        }
+    }
+
+    // dati: replay delle XOR registrate
+    std::vector<uint8_t> R((size_t)m * T);
+    for (int r = 0; r < m; ++r) std::memcpy(R.data() + (size_t)r * T, rhs[r], T);
+    for (auto& o : ops) ::fec::xor_bytes(R.data() + (size_t)o.first * T, R.data() + (size_t)o.second * T, T);
+
+    // core denso GF(256): righe GF(2) non usate + H righe HDPC, riscritte sulle colonne inattive
+    const Gf256& g = gf();
+    const size_t ni = (size_t)n_inact;
+    std::vector<uint8_t> A, B;
+    size_t rc = 0;
+    auto add_core_row = [&]() {
+        A.resize((rc + 1) * ni, 0);
+        B.resize((rc + 1) * T, 0);
+        return rc++;
+    };
+    auto for_mask = [](const std::vector<uint64_t>& v, auto&& f) {
+        for (size_t w = 0; w < v.size(); ++w)
+            for (uint64_t b = v[w]; b; b &= b - 1) f(w * 64 + std::countr_zero(b));
+    };
+    for (int r = 0; r < m; ++r) {
+        if (used[r]) continue;
+        size_t i = add_core_row();
+        for_mask(mask[r], [&](size_t qi) { A[i * ni + qi] = 1; });
+        std::memcpy(B.data() + i * T, R.data() + (size_t)r * T, T);
+    }
+    const uint32_t KS = p.K + p.S;
+    for (uint32_t h = 0; h < p.H; ++h) {
+        size_t i = add_core_row();
+        uint8_t* a = A.data() + i * ni;
+        uint8_t* b = B.data() + i * T;
+        for (uint32_t j = 0; j < n; ++j) {
+            uint8_t coef = j < KS ? p.hdpc[(size_t)h * KS + j] : (j == KS + h ? 1 : 0);
+            if (!coef) continue;
+            if (st[j] == INACTIVE) { a[inact_idx[j]] ^= coef; continue; }
+            int r = pivot[j];
+            g.mul_add(b, R.data() + (size_t)r * T, coef, T);
+            for_mask(mask[r], [&](size_t qi) { a[qi] ^= coef; });
+        }
+    }
+    // Gauss-Jordan sul core
+    std::vector<size_t> perm(rc);
+    for (size_t i = 0; i < rc; ++i) perm[i] = i;
+    for (size_t c = 0; c < ni; ++c) {
+        size_t k = c;
+        while (k < rc && !A[perm[k] * ni + c]) ++k;
+        if (k == rc) return std::nullopt;
+        std::swap(perm[c], perm[k]);
+        uint8_t* pa = A.data() + perm[c] * ni;
+        uint8_t* pb = B.data() + perm[c] * T;
+        uint8_t inv = g.inv(pa[c]);
+        g.scale(pa + c, inv, ni - c);
+        g.scale(pb, inv, T);
+        for (size_t i = 0; i < rc; ++i) {
+            if (i == c) continue;
+            uint8_t* ra = A.data() + perm[i] * ni;
+            uint8_t f = ra[c];
+            if (!f) continue;
+            g.mul_add(ra + c, pa + c, f, ni - c);
+            g.mul_add(B.data() + perm[i] * T, pb, f, T);
+        }
+    }
+
+    std::vector<uint8_t> out((size_t)n * T, 0);
+    for (uint32_t c = 0; c < n; ++c) {
+        uint8_t* dst = out.data() + (size_t)c * T;
+        if (st[c] == INACTIVE) {
+            std::memcpy(dst, B.data() + perm[inact_idx[c]] * T, T);
+            continue;
+        }
+        int r = pivot[c];
+        std::memcpy(dst, R.data() + (size_t)r * T, T);
+        for_mask(mask[r], [&](size_t qi) { ::fec::xor_bytes(dst, B.data() + perm[qi] * T, T); });
+    }
+    return out;
+}
+
+// Righe GF(2) (LDPC + ESI 0..K-1) del sistema che definisce gli intermedi in modo sistematico
+Rows systematic_rows(const RqParams& p) {
+    Rows rows = p.ldpc_rows();
+    rows.resize(p.S + p.K);
+    for (uint32_t i = 0; i < p.K; ++i) p.lt_indices(i, rows[p.S + i]);
+    return rows;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Parametri
+
+const RqParams& RqParams::for_K(uint32_t K) {
+    static std::mutex mu;
+    static std::map<uint32_t, std::unique_ptr<RqParams>> cache;
+    std::lock_guard<std::mutex> lock(mu);
+    auto& slot = cache[K];
+    if (slot) return *slot;
+
+    auto p = std::make_unique<RqParams>();
+    p->K = K;
+    uint32_t X = 1;
+    while ((uint64_t)X * (X - 1) < 2ull * K) ++X;
+    p->S = next_prime((K + 99) / 100 + X);
+    uint32_t H = 1;
+    while (choose(H, (H + 1) / 2) < (uint64_t)K + p->S) ++H;
+    p->H = H;
+    p->L = K + p->S + p->H;
+    p->W = K + p->S;
+    p->Wp = next_prime(p->W);
+    p->Pp = next_prime(p->P());
+
+    // HDPC: coefficienti pseudo-casuali densi, deterministici in K
+    p->hdpc.resize((size_t)H * (K + p->S));
+    ::fec::SplitMix g(K ^ 0x48445043u);
+    uint64_t w = 0;
+    for (size_t i = 0; i < p->hdpc.size(); ++i) {
+        if (i % 8 == 0) w = g.next();
+        p->hdpc[i] = (uint8_t)(w >> (8 * (i % 8)));
+    }
+
+    // Indice sistematico: il primo J per cui il sistema (vincoli + ESI < K) ha rango L
+    const std::vector<uint8_t> zero(1, 0);
+    for (p->J = 0;; ++p->J) {
+        if (p->J > 4096) throw std::runtime_error("AuroraRaptorQ: nessun indice sistematico per K=" + std::to_string(K));
+        Rows rows = systematic_rows(*p);
+        std::vector<const uint8_t*> rhs(rows.size(), zero.data());
+        if (solve_intermediate(*p, 1, rows, rhs)) break;
+    }
+    slot = std::move(p);
+    return *slot;
+}
+
+void RqParams::lt_indices(uint32_t esi, std::vector<uint32_t>& out) const {
+    ::fec::SplitMix g(esi * 0x9E3779B1u + J * 0x7F4A7C15u);
+    const uint32_t P = this->P();
+    uint32_t d = std::min(r10_degree((uint32_t)(g.next() >> 44)), W);
+    uint32_t d1 = std::min(d < 4 ? 3u : 2u, P);   // righe di grado basso: un vicino PI in piu'
+    out.clear();
+    out.reserve(d + d1);
+    // passo costante a modulo un primo: i primi n valori sono tutti distinti
+    auto walk = [&](uint32_t cnt, uint32_t n, uint32_t np, uint32_t base) {
+        uint32_t a = 1 + g.below(np - 1);
+        uint32_t b = g.below(np);
+        for (uint32_t j = 0; j < cnt; ++j) {
+            if (j) b = (b + a) % np;
+            while (b >= n) b = (b + a) % np;
+            out.push_back(base + b);
+        }
+    };
+    walk(d, W, Wp, 0);
+    walk(d1, P, Pp, W);
+    std::sort(out.begin(), out.end());
+}
+
+std::vector<std::vector<uint32_t>> RqParams::ldpc_rows() const {
+    Rows rows(S);
+    // ogni sorgente entra in 3 vincoli
+    for (uint32_t i = 0; i < K; ++i) {
+        uint32_t a = 1 + (S > 1 ? (i / S) % (S - 1) : 0);
+        uint32_t b = i % S;
+        rows[b].push_back(i);
+        b = (b + a) % S;
+        rows[b].push_back(i);
+        b = (b + a) % S;
+        rows[b].push_back(i);
+    }
+    // il vincolo j chiude con l'intermedio K+j e tocca due PI consecutivi
+    for (uint32_t j = 0; j < S; ++j) {
+        rows[j].push_back(K + j);
+        rows[j].push_back(W + j % P());
+        rows[j].push_back(W + (j + 1) % P());
+        cancel_pairs(rows[j]);
+    }
+    return rows;
+}
+
+// ---------------------------------------------------------------------------
+// Encoder
+
+std::vector<EncodedSymbol> AuroraRaptorQ::encode_all(const uint8_t* data, size_t size, size_t T, uint32_t repair) const {
+    if (T == 0) throw std::invalid_argument("AuroraRaptorQ: T deve essere > 0");
+    const uint32_t K = (uint32_t)std::max<size_t>(1, (size + T - 1) / T);
+    const RqParams& p = RqParams::for_K(K);
+
+    std::vector<uint8_t> src((size_t)K * T, 0);
+    if (size) std::memcpy(src.data(), data, size);
+
+    std::vector<EncodedSymbol> out;
+    out.reserve(K + repair);
+    for (uint32_t i = 0; i < K; ++i)
+        out.push_back({i, std::vector<uint8_t>(src.begin() + (size_t)i * T, src.begin() + (size_t)(i + 1) * T)});
+    if (!repair) return out;
+
+    Rows rows = systematic_rows(p);
+    const std::vector<uint8_t> zero(T, 0);
+    std::vector<const uint8_t*> rhs(rows.size(), zero.data());
+    for (uint32_t i = 0; i < K; ++i) rhs[p.S + i] = src.data() + (size_t)i * T;
+    auto C = solve_intermediate(p, T, rows, rhs);
+    if (!C) throw std::runtime_error("AuroraRaptorQ: sistema sistematico singolare");
+
+    std::vector<uint32_t> idx;
+    for (uint32_t r = 0; r < repair; ++r) {
+        uint32_t esi = K + r;
+        p.lt_indices(esi, idx);
+        std::vector<uint8_t> sym(T, 0);
+        for (uint32_t c : idx) ::fec::xor_bytes(sym.data(), C->data() + (size_t)c * T, T);
+        out.push_back({esi, std::move(sym)});
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Decoder
+
+RqDecoder::RqDecoder(size_t size, size_t T)
+    : size_(size), T_(T), p_(&RqParams::for_K((uint32_t)std::max<size_t>(1, T ? (size + T - 1) / T : 1))) {
+    if (T == 0) throw std::invalid_argument("AuroraRaptorQ: T deve essere > 0");
+    src_slot_.assign(p_->K, -1);
+}
+
+bool RqDecoder::add(uint32_t esi, const uint8_t* data, size_t n) {
+    if (n > T_ || done_ || !seen_.insert(esi).second) return false;
+    size_t slot = esis_.size();
+    esis_.push_back(esi);
+    data_.resize(data_.size() + T_, 0);
+    if (n) std::memcpy(data_.data() + slot * T_, data, n);
+    if (esi < p_->K) {
+        src_slot_[esi] = (int32_t)slot;
+        ++n_src_;
+    }
+    return true;
+}
+
+bool RqDecoder::ready() const {
+    return done_.has_value() || (esis_.size() >= p_->K && esis_.size() > tried_at_);
+}
+
+std::optional<std::vector<uint8_t>> RqDecoder::decode() {
+    if (done_) return done_;
+    const RqParams& p = *p_;
+    if (esis_.size() < p.K) return std::nullopt;
+
+    std::vector<uint8_t> out((size_t)p.K * T_, 0);
+    if (n_src_ == p.K) {
+        // tutti i blocchi sorgente arrivati: solo copia
+        for (uint32_t i = 0; i < p.K; ++i)
+            std::memcpy(out.data() + (size_t)i * T_, data_.data() + (size_t)src_slot_[i] * T_, T_);
+    } else {
+        Rows rows = p.ldpc_rows();
+        const std::vector<uint8_t> zero(T_, 0);
+        std::vector<const uint8_t*> rhs(rows.size(), zero.data());
+        rows.resize(p.S + esis_.size());
+        rhs.resize(rows.size());
+        for (size_t r = 0; r < esis_.size(); ++r) {
+            p.lt_indices(esis_[r], rows[p.S + r]);
+            rhs[p.S + r] = data_.data() + r * T_;
+        }
+        auto C = solve_intermediate(p, T_, rows, rhs);
+        if (!C) {
+            tried_at_ = esis_.size();
+            return std::nullopt;
+        }
+        std::vector<uint32_t> idx;
+        for (uint32_t i = 0; i < p.K; ++i) {
+            uint8_t* dst = out.data() + (size_t)i * T_;
+            if (src_slot_[i] >= 0) {
+                std::memcpy(dst, data_.data() + (size_t)src_slot_[i] * T_, T_);
+                continue;
+            }
+            p.lt_indices(i, idx);
+            for (uint32_t c : idx) ::fec::xor_bytes(dst, C->data() + (size_t)c * T_, T_);
+        }
+    }
+    out.resize(size_);
+    done_ = std::move(out);
+    return done_;
+}
+
+} // namespace fec
+} // namespace aurora
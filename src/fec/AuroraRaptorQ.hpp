@@ -0,0 +1,93 @@
+#pragma once
+
+// AuroraRaptorQ: codec fountain in stile RaptorQ/R10, interamente nel repo
+// (nessuna dipendenza da libRaptorQ / Eigen).
+//
+// Struttura (blocco sorgente di K simboli da T byte):
+//   - precode: L = K + S + H simboli intermedi legati da S vincoli LDPC in GF(2)
+//     (3 sorgenti per vincolo, schema R10) e H vincoli HDPC densi in GF(256)
+//   - codice esterno LT: grado dalla distribuzione R10 sui W = K + S intermedi LT
+//     piu' 2-3 vicini tra i P = H intermedi permanentemente inattivi (PI), come in
+//     RaptorQ; i vicini sono distinti (passo costante modulo un primo >= W o >= P)
+//   - sistematico: per ogni K si cerca l'indice J per cui le righe degli ESI 0..K-1
+//     rendono il sistema invertibile, quindi ESI < K sono i blocchi in chiaro
+//   - decodifica: peeling + inattivazione sulle righe GF(2) (come fec::PeelingDecoder)
+//     con le colonne PI inattive da subito; colonne inattive e righe HDPC vanno in un
+//     core denso risolto in GF(256)
+//
+// Overhead di ricezione tipico: successo quasi certo con K+2 simboli (aurora_fec_bench rq).
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
+namespace aurora {
+namespace fec {
+
+struct EncodedSymbol {
+    uint32_t esi;                 // Encoding Symbol ID: < K sorgente, >= K repair
+    std::vector<uint8_t> bytes;   // T byte
+};
+
+// Parametri derivati da K (calcolati una volta per K e messi in cache)
+struct RqParams {
+    uint32_t K = 0;      // simboli sorgente
+    uint32_t S = 0;      // vincoli LDPC (primo)
+    uint32_t H = 0;      // vincoli HDPC
+    uint32_t L = 0;      // simboli intermedi = K + S + H
+    uint32_t W = 0;      // intermedi LT = K + S (gli altri P = H sono PI)
+    uint32_t Wp = 0;     // primo >= W per i vicini LT
+    uint32_t Pp = 0;     // primo >= P per i vicini PI
+    uint32_t J = 0;      // indice sistematico
+    std::vector<uint8_t> hdpc;   // H x (K+S) coefficienti GF(256) dei vincoli HDPC
+
+    uint32_t P() const { return L - W; }
+
+    static const RqParams& for_K(uint32_t K);
+    // indici (distinti) degli intermedi combinati nel simbolo con questo ESI
+    void lt_indices(uint32_t esi, std::vector<uint32_t>& out) const;
+    // righe dei vincoli LDPC (S righe GF(2), termine noto zero)
+    std::vector<std::vector<uint32_t>> ldpc_rows() const;
+};
+
+class RqDecoder {
+public:
+    RqDecoder(size_t size, size_t T);
+
+    // false se l'ESI era gia' stato ricevuto (o la dimensione non torna)
+    bool add(uint32_t esi, const uint8_t* data, size_t n);
+    bool add(const EncodedSymbol& s) { return add(s.esi, s.bytes.data(), s.bytes.size()); }
+
+    // almeno K simboli distinti e nuovi simboli dall'ultimo decode() fallito
+    bool ready() const;
+    // payload (size byte) oppure nullopt se il sistema non ha ancora rango pieno
+    std::optional<std::vector<uint8_t>> decode();
+
+    size_t received() const { return esis_.size(); }
+    uint32_t K() const { return p_->K; }
+
+private:
+    size_t size_, T_;
+    const RqParams* p_;
+    std::vector<uint32_t> esis_;
+    std::vector<uint8_t> data_;        // simboli ricevuti, T byte ciascuno, nell'ordine di esis_
+    std::vector<int32_t> src_slot_;    // ESI sorgente -> indice in esis_, -1 se assente
+    std::unordered_set<uint32_t> seen_;
+    size_t n_src_ = 0, tried_at_ = 0;
+    std::optional<std::vector<uint8_t>> done_;
+};
+
+class AuroraRaptorQ {
+public:
+    // ESI 0..K-1 (blocchi sorgente) seguiti da `repair` simboli di riparazione
+    std::vector<EncodedSymbol> encode_all(const uint8_t* data, size_t size, size_t T, uint32_t repair) const;
+    std::unique_ptr<RqDecoder> make_decoder(size_t size, size_t T) const {
+        return std::make_unique<RqDecoder>(size, T);
+    }
+};
+
+} // namespace fec
+} // namespace aurora
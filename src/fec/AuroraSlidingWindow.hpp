@@ -0,0 +1,285 @@
+#pragma once
+
+// Codec a finestra scorrevole (RLNC convoluzionale su GF(256)) per flussi di messaggi
+// piccoli e continui (NERVE): ogni messaggio parte subito come simbolo sorgente, i repair
+// sono combinazioni casuali degli ultimi `window` sorgenti. Il ricevitore mantiene le
+// equazioni in forma ridotta (RREF) e consegna i messaggi in ordine appena sono noti,
+// senza aspettare la fine di un blocco.
+//
+// Canale assunto FIFO (perdite si', riordino no): un sorgente e' dichiarato perso quando
+// nessun repair futuro puo' piu' coprirlo.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "AuroraGf256.hpp"
+
+namespace fec {
+
+struct SwSymbol {
+    uint32_t lo = 0;             // primo sorgente coperto (per un sorgente: il suo seq)
+    uint32_t n = 1;              // sorgenti coperti: [lo, lo + n)
+    uint64_t seed = 0;           // 0 = sorgente in chiaro, altrimenti seme dei coefficienti
+    std::vector<uint8_t> data;   // symbol_size byte: [len u16 LE][messaggio][padding]
+    bool is_source() const { return seed == 0; }
+};
+
+struct SwDelivery {
+    uint32_t seq = 0;
+    bool lost = false;           // non piu' recuperabile: il ricevitore lo salta
+    std::vector<uint8_t> bytes;
+};
+
+// i-esimo coefficiente (non nullo) di un repair: dipende solo da (seed, i)
+inline uint8_t sw_coefficient(uint64_t seed, uint32_t i) {
+    uint64_t z = seed + (uint64_t)(i + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return (uint8_t)(1 + z % 255);
+}
+
+class SlidingWindowEncoder {
+public:
+    static constexpr size_t LEN_BYTES = 2;
+
+    explicit SlidingWindowEncoder(size_t symbol_size, uint32_t window = 32, uint64_t seed = 1)
+        : S_(symbol_size), W_(std::max(window, 1u)), rng_(seed) {
+        if (S_ <= LEN_BYTES) throw std::invalid_argument("SlidingWindowEncoder: symbol_size troppo piccolo");
+    }
+
+    size_t symbol_size() const { return S_; }
+    size_t max_message() const { return std::min<size_t>(S_ - LEN_BYTES, 0xFFFF); }
+    uint32_t window() const { return W_; }
+    uint32_t next_seq() const { return next_; }
+    uint32_t window_lo() const { return next_ - (uint32_t)win_.size(); }
+    size_t window_size() const { return win_.size(); }
+
+    // Accoda un messaggio e ritorna il suo simbolo sorgente (seq = lo)
+    SwSymbol push(const uint8_t* msg, size_t len) {
+        if (len > max_message()) throw std::length_error("SlidingWindowEncoder: messaggio piu' grande del simbolo");
+        SwSymbol s;
+        s.lo = next_++;
+        s.data.assign(S_, 0);
+        s.data[0] = (uint8_t)len;
+        s.data[1] = (uint8_t)(len >> 8);
+        if (len) std::memcpy(s.data.data() + LEN_BYTES, msg, len);
+        win_.push_back(s.data);
+        if (win_.size() > W_) win_.pop_front();
+        return s;
+    }
+    SwSymbol push(const std::vector<uint8_t>& msg) { return push(msg.data(), msg.size()); }
+
+    // Repair sull'intera finestra corrente (n == 0 se la finestra e' vuota: niente da inviare)
+    SwSymbol repair() {
+        SwSymbol s;
+        s.lo = window_lo();
+        s.n = (uint32_t)win_.size();
+        s.seed = next_seed();
+        s.data.assign(S_, 0);
+        const Gf256& g = gf256();
+        for (uint32_t i = 0; i < s.n; ++i) g.mul_add(s.data.data(), win_[i].data(), sw_coefficient(s.seed, i), S_);
+        return s;
+    }
+
+    // Feedback del ricevitore: i sorgenti < seq sono consegnati e escono dalla finestra
+    void ack(uint32_t seq) {
+        while (!win_.empty() && window_lo() < seq) win_.pop_front();
+    }
+
+private:
+    uint64_t next_seed() {
+        uint64_t s;
+        do {
+            rng_ += 0x9E3779B97F4A7C15ULL;
+            s = (rng_ ^ (rng_ >> 31)) * 0xBF58476D1CE4E5B9ULL;
+        } while (!s);
+        return s;
+    }
+
+    size_t S_;
+    uint32_t W_;
+    uint32_t next_ = 0;
+    uint64_t rng_;
+    std::deque<std::vector<uint8_t>> win_;   // sorgenti [window_lo, next_)
+};
+
+class SlidingWindowDecoder {
+public:
+    // window: la stessa dell'encoder (0 = ignota, le perdite si scoprono solo dai repair)
+    explicit SlidingWindowDecoder(size_t symbol_size, uint32_t window = 32) : S_(symbol_size), W_(window) {}
+
+    // Integra un simbolo e ritorna i messaggi diventati consegnabili, in ordine di seq
+    std::vector<SwDelivery> push(const SwSymbol& s) {
+        std::vector<SwDelivery> out;
+        if (s.data.size() != S_ || s.n == 0) return out;
+        ++received_;
+        if (s.is_source()) {
+            // l'encoder tiene al piu' W sorgenti: i repair successivi partono da lo + 1 - W
+            if (W_ && s.lo + 1 > W_) horizon_ = std::max(horizon_, s.lo + 1 - W_);
+            learn(s.lo, s.data);
+        } else {
+            horizon_ = std::max(horizon_, s.lo);
+            Row r{s.lo, std::vector<uint8_t>(s.n), s.data};
+            for (uint32_t i = 0; i < s.n; ++i) r.c[i] = sw_coefficient(s.seed, i);
+            insert(std::move(r));
+        }
+        settle();
+        deliver(out);
+        return out;
+    }
+
+    uint32_t next_seq() const { return next_; }      // prossimo messaggio da consegnare
+    size_t pending_rows() const { return rows_.size(); }
+    size_t received() const { return received_; }
+    size_t recovered() const { return recovered_; }  // sorgenti ricostruiti dai repair
+    size_t lost() const { return lost_; }
+
+private:
+    // Equazione sulle incognite [lo, lo + c.size()); in rows_ lo e' il pivot (coefficiente 1)
+    struct Row {
+        uint32_t lo;
+        std::vector<uint8_t> c;
+        std::vector<uint8_t> d;
+        uint32_t end() const { return lo + (uint32_t)c.size(); }
+        uint8_t at(uint32_t seq) const { return seq >= lo && seq < end() ? c[seq - lo] : 0; }
+    };
+
+    // a += f * b
+    void axpy(Row& a, const Row& b, uint8_t f) const {
+        const Gf256& g = gf256();
+        if (b.lo < a.lo) {
+            a.c.insert(a.c.begin(), a.lo - b.lo, 0);
+            a.lo = b.lo;
+        }
+        if (b.end() > a.end()) a.c.resize(b.end() - a.lo, 0);
+        for (size_t i = 0; i < b.c.size(); ++i) a.c[b.lo - a.lo + i] ^= g.mul(f, b.c[i]);
+        g.mul_add(a.d.data(), b.d.data(), f, S_);
+    }
+
+    static void trim(Row& r) {
+        while (!r.c.empty() && !r.c.back()) r.c.pop_back();
+        size_t z = 0;
+        while (z < r.c.size() && !r.c[z]) ++z;
+        r.c.erase(r.c.begin(), r.c.begin() + z);
+        r.lo += (uint32_t)z;
+    }
+
+    // Riduce r contro i sorgenti noti e le righe esistenti, poi la aggiunge mantenendo la RREF
+    void insert(Row r) {
+        const Gf256& g = gf256();
+        for (uint32_t seq = r.lo; seq < r.end(); ++seq) {
+            uint8_t f = r.c[seq - r.lo];
+            if (!f) continue;
+            auto k = known_.find(seq);
+            if (k != known_.end()) {
+                g.mul_add(r.d.data(), k->second.data(), f, S_);
+                r.c[seq - r.lo] = 0;
+            } else if (seq < next_) {
+                return;   // repair fuori ordine su sorgenti gia' scartati: inutilizzabile
+            } else {
+                auto p = rows_.find(seq);
+                if (p != rows_.end()) axpy(r, p->second, f);   // aggiunge solo colonne non pivot > seq
+            }
+        }
+        trim(r);
+        if (r.c.empty()) return;   // non innovativo
+        const uint8_t inv = g.inv(r.c[0]);
+        for (auto& x : r.c) x = g.mul(x, inv);
+        g.scale(r.d.data(), inv, S_);
+        for (auto& [pivot, o] : rows_) {
+            uint8_t f = o.at(r.lo);
+            if (!f) continue;
+            axpy(o, r, f);
+            trim(o);
+        }
+        rows_.emplace(r.lo, std::move(r));
+    }
+
+    // Sorgente noto (ricevuto o ricostruito): esce da tutte le equazioni
+    void learn(uint32_t seq, std::vector<uint8_t> data) {
+        if (seq < next_ || !known_.emplace(seq, data).second) return;
+        const Gf256& g = gf256();
+        std::vector<Row> reinsert;
+        for (auto it = rows_.begin(); it != rows_.end();) {
+            Row& r = it->second;
+            uint8_t f = r.at(seq);
+            if (!f) { ++it; continue; }
+            g.mul_add(r.d.data(), data.data(), f, S_);
+            r.c[seq - r.lo] = 0;
+            trim(r);
+            if (it->first == seq) {   // era il pivot: la riga va ridotta di nuovo
+                reinsert.push_back(std::move(r));
+                it = rows_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        for (auto& r : reinsert)
+            if (!r.c.empty()) insert(std::move(r));
+    }
+
+    // Righe con il solo pivot: sorgente ricostruito
+    void settle() {
+        for (;;) {
+            auto it = std::find_if(rows_.begin(), rows_.end(), [](const auto& kv) { return kv.second.c.size() == 1; });
+            if (it == rows_.end()) return;
+            uint32_t seq = it->first;
+            std::vector<uint8_t> d = std::move(it->second.d);
+            rows_.erase(it);
+            ++recovered_;
+            learn(seq, std::move(d));
+        }
+    }
+
+    // m non arrivera' piu': nessun repair futuro (lo >= horizon_) tocca m o le altre
+    // incognite delle equazioni che lo contengono. Con la finestra nota si rinuncia comunque
+    // a m oltre una finestra dietro l'orizzonte: sotto perdite oltre la capacita' del codice
+    // le catene di eliminazione allungano le righe e la consegna resterebbe ferma
+    bool sealed(uint32_t m) const {
+        if (m >= horizon_) return false;
+        if (W_ && horizon_ - m > W_) return true;
+        for (const auto& [pivot, r] : rows_)
+            if (r.at(m) && r.end() > horizon_) return false;
+        return true;
+    }
+
+    void deliver(std::vector<SwDelivery>& out) {
+        for (;;) {
+            auto k = known_.find(next_);
+            if (k != known_.end()) {
+                const auto& d = k->second;
+                size_t len = std::min<size_t>(d[0] | (size_t)d[1] << 8, S_ - SlidingWindowEncoder::LEN_BYTES);
+                out.push_back({next_, false, std::vector<uint8_t>(d.begin() + 2, d.begin() + 2 + len)});
+            } else if (sealed(next_)) {
+                for (auto it = rows_.begin(); it != rows_.end();)
+                    it = it->second.at(next_) ? rows_.erase(it) : std::next(it);
+                out.push_back({next_, true, {}});
+                ++lost_;
+            } else {
+                break;
+            }
+            ++next_;
+        }
+        // i sorgenti consegnati servono ancora finche' un repair futuro puo' coprirli
+        const uint32_t keep = std::min(next_, horizon_);
+        known_.erase(known_.begin(), known_.lower_bound(keep));
+    }
+
+    size_t S_;
+    uint32_t W_;
+    uint32_t next_ = 0;      // prossimo seq da consegnare
+    uint32_t horizon_ = 0;   // i repair futuri coprono solo seq >= horizon_
+    std::map<uint32_t, std::vector<uint8_t>> known_;
+    std::map<uint32_t, Row> rows_;
+    size_t received_ = 0, recovered_ = 0, lost_ = 0;
+};
+
+} // namespace fec
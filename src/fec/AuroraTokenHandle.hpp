@@ -0,0 +1,39 @@
+#pragma once
+
+// Handle a 64 bit dei token: sul filo e in memoria al posto della stringa dell'id, che resta
+// solo ai bordi dell'API. L'id di un Token e' util::h64, le 16 cifre esadecimali di
+// token_digest(): l'handle e' quel numero. Altri id (test, mittenti esterni) passano dallo
+// stesso digest. Niente allocazioni: va bene anche per la configurazione embedded.
+
+#include <cstdint>
+#include <string_view>
+
+namespace fec {
+
+using TokenHandle = uint64_t;
+
+// Digest a 64 bit (lo stesso di util::h64)
+inline uint64_t token_digest(std::string_view s) {
+    uint64_t z = 0x9E3779B97F4A7C15ULL;
+    for (unsigned char c : s) z ^= (uint64_t)c + 0x9e3779b97f4a7c15ULL + (z << 6) + (z >> 2);
+    z ^= z << 13;
+    z ^= z >> 7;
+    z ^= z << 17;
+    return z;
+}
+
+inline TokenHandle token_handle(std::string_view id) {
+    if (id.size() == 16) {
+        uint64_t h = 0;
+        bool hex = true;
+        for (char c : id) {
+            int v = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+            if (v < 0) { hex = false; break; }
+            h = h << 4 | (uint64_t)v;
+        }
+        if (hex) return h;
+    }
+    return token_digest(id);
+}
+
+} // namespace fec
@@ -0,0 +1,110 @@
+#pragma once
+
+// Pool di worker persistente per il lavoro data-parallel del codec fountain
+// (fec::emit_batches): un job alla volta, parallel_for distribuisce gli indici
+// [0, n) con un contatore atomico e il thread chiamante lavora insieme ai worker.
+//
+// Override per test/benchmark: AURORA_FEC_THREADS=<n> (1 = tutto sul chiamante)
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fec {
+
+class WorkerPool {
+public:
+    explicit WorkerPool(unsigned threads) {
+        for (unsigned i = 1; i < threads; ++i) workers_.emplace_back([this] { loop(); });
+    }
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : workers_) t.join();
+    }
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // worker + thread chiamante
+    unsigned threads() const { return (unsigned)workers_.size() + 1; }
+
+    // f(i) per ogni i in [0, n), ritorna quando tutti gli indici sono stati eseguiti.
+    // f non deve lanciare eccezioni; chiamanti concorrenti vengono serializzati.
+    void parallel_for(size_t n, const std::function<void(size_t)>& f) {
+        if (workers_.empty() || n < 2) {
+            for (size_t i = 0; i < n; ++i) f(i);
+            return;
+        }
+        std::lock_guard<std::mutex> job(job_mu_);
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            fn_ = &f;
+            n_ = n;
+            next_.store(0, std::memory_order_relaxed);
+            active_ = workers_.size();
+            ++gen_;
+        }
+        cv_.notify_all();
+        run();
+        std::unique_lock<std::mutex> lk(mu_);
+        done_cv_.wait(lk, [&] { return active_ == 0; });
+        fn_ = nullptr;
+    }
+
+    static unsigned default_threads() {
+        if (const char* env = std::getenv("AURORA_FEC_THREADS")) {
+            int v = std::atoi(env);
+            if (v > 0) return (unsigned)v;
+        }
+        unsigned hw = std::thread::hardware_concurrency();
+        return hw ? std::min(hw, 16u) : 1;
+    }
+
+    // Pool di processo, creato al primo uso
+    static WorkerPool& shared() {
+        static WorkerPool pool(default_threads());
+        return pool;
+    }
+
+private:
+    void run() {
+        const auto& f = *fn_;
+        for (size_t i; (i = next_.fetch_add(1, std::memory_order_relaxed)) < n_;) f(i);
+    }
+
+    void loop() {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lk(mu_);
+                cv_.wait(lk, [&] { return stop_ || gen_ != seen; });
+                if (stop_) return;
+                seen = gen_;
+            }
+            run();
+            std::lock_guard<std::mutex> lk(mu_);
+            if (--active_ == 0) done_cv_.notify_one();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex mu_, job_mu_;
+    std::condition_variable cv_, done_cv_;
+    const std::function<void(size_t)>* fn_ = nullptr;
+    size_t n_ = 0, active_ = 0;
+    std::atomic<size_t> next_{0};
+    uint64_t gen_ = 0;
+    bool stop_ = false;
+};
+
+} // namespace fec
@@ -0,0 +1,316 @@
+#pragma once
+
+// Kernel XOR di simboli per il codec fountain (fec::Encoder / fec::Decoder):
+// varianti portable, SSE2, AVX2 e AVX-512 scelte a runtime via CPUID.
+// Tutte le XOR su payload passano da fec::xor_bytes() -> simd::xor_into().
+//
+// Per le dimensioni simbolo comuni (FIXED_SIZES) ogni variante ha anche un kernel a
+// dimensione fissa: numero di iterazioni noto al compilatore, loop srotolato per intero,
+// niente coda. xor_for(S) li sceglie a runtime, xor_fixed<S>() a compile time.
+//
+// Override per test/benchmark: AURORA_XOR_KERNEL=portable|sse2|avx2|avx512
+//                              AURORA_XOR_FIXED=0 (solo kernel generici)
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__clang__)
+  #define AURORA_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__)
+  #define AURORA_UNROLL _Pragma("GCC unroll 32")
+#else
+  #define AURORA_UNROLL
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+  #define AURORA_XOR_X86 1
+  #include <immintrin.h>
+  #if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+    #define AURORA_TARGET(x)
+  #else
+    #define AURORA_TARGET(x) __attribute__((target(x)))
+  #endif
+#endif
+
+namespace fec {
+namespace simd {
+
+using XorFn = void (*)(uint8_t* dst, const uint8_t* src, size_t n);
+
+// Fallback portabile: parole da 64 bit (memcpy evita problemi di allineamento)
+inline void xor_portable(uint8_t* dst, const uint8_t* src, size_t n) {
+    size_t b = 0;
+    for (; b + 8 <= n; b += 8) {
+        uint64_t x, y;
+        std::memcpy(&x, dst + b, 8);
+        std::memcpy(&y, src + b, 8);
+        x ^= y;
+        std::memcpy(dst + b, &x, 8);
+    }
+    for (; b < n; ++b) dst[b] ^= src[b];
+}
+
+// Kernel a dimensione fissa: N multiplo di 64, stessa firma di XorFn (n ignorato)
+template<size_t N>
+inline void xor_fixed_portable(uint8_t* dst, const uint8_t* src, size_t) {
+    static_assert(N % 64 == 0, "xor_fixed: N multiplo di 64");
+    AURORA_UNROLL
+    for (size_t b = 0; b < N; b += 8) {
+        uint64_t x, y;
+        std::memcpy(&x, dst + b, 8);
+        std::memcpy(&y, src + b, 8);
+        x ^= y;
+        std::memcpy(dst + b, &x, 8);
+    }
+}
+
+#ifdef AURORA_XOR_X86
+AURORA_TARGET("sse2")
+inline void xor_sse2(uint8_t* dst, const uint8_t* src, size_t n) {
+    size_t b = 0;
+    for (; b + 64 <= n; b += 64) {
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(dst + b));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(dst + b + 16));
+        __m128i a2 = _mm_loadu_si128((const __m128i*)(dst + b + 32));
+        __m128i a3 = _mm_loadu_si128((const __m128i*)(dst + b + 48));
+        a0 = _mm_xor_si128(a0, _mm_loadu_si128((const __m128i*)(src + b)));
+        a1 = _mm_xor_si128(a1, _mm_loadu_si128((const __m128i*)(src + b + 16)));
+        a2 = _mm_xor_si128(a2, _mm_loadu_si128((const __m128i*)(src + b + 32)));
+        a3 = _mm_xor_si128(a3, _mm_loadu_si128((const __m128i*)(src + b + 48)));
+        _mm_storeu_si128((__m128i*)(dst + b), a0);
+        _mm_storeu_si128((__m128i*)(dst + b + 16), a1);
+        _mm_storeu_si128((__m128i*)(dst + b + 32), a2);
+        _mm_storeu_si128((__m128i*)(dst + b + 48), a3);
+    }
+    for (; b + 16 <= n; b += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(dst + b));
+        a = _mm_xor_si128(a, _mm_loadu_si128((const __m128i*)(src + b)));
+        _mm_storeu_si128((__m128i*)(dst + b), a);
+    }
+    xor_portable(dst + b, src + b, n - b);
+}
+
+// Passi da 16 byte finche' dst non e' allineato ad `align`: gli store larghi che
+// attraversano una cache line rompono lo store forwarding sull'accumulatore
+// (mix in Encoder::emit() e' allineato solo a 16 byte da malloc)
+AURORA_TARGET("sse2")
+inline size_t xor_align_head(uint8_t* dst, const uint8_t* src, size_t n, uintptr_t align) {
+    size_t b = 0;
+    while (((uintptr_t)(dst + b) & (align - 1)) && b + 16 <= n) {
+        if ((uintptr_t)(dst + b) & 15) { dst[b] ^= src[b]; ++b; continue; }
+        __m128i a = _mm_loadu_si128((const __m128i*)(dst + b));
+        a = _mm_xor_si128(a, _mm_loadu_si128((const __m128i*)(src + b)));
+        _mm_storeu_si128((__m128i*)(dst + b), a);
+        b += 16;
+    }
+    return b;
+}
+
+AURORA_TARGET("avx2")
+inline void xor_avx2(uint8_t* dst, const uint8_t* src, size_t n) {
+    size_t b = xor_align_head(dst, src, n, 32);
+    for (; b + 128 <= n; b += 128) {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(dst + b));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(dst + b + 32));
+        __m256i a2 = _mm256_loadu_si256((const __m256i*)(dst + b + 64));
+        __m256i a3 = _mm256_loadu_si256((const __m256i*)(dst + b + 96));
+        a0 = _mm256_xor_si256(a0, _mm256_loadu_si256((const __m256i*)(src + b)));
+        a1 = _mm256_xor_si256(a1, _mm256_loadu_si256((const __m256i*)(src + b + 32)));
+        a2 = _mm256_xor_si256(a2, _mm256_loadu_si256((const __m256i*)(src + b + 64)));
+        a3 = _mm256_xor_si256(a3, _mm256_loadu_si256((const __m256i*)(src + b + 96)));
+        _mm256_storeu_si256((__m256i*)(dst + b), a0);
+        _mm256_storeu_si256((__m256i*)(dst + b + 32), a1);
+        _mm256_storeu_si256((__m256i*)(dst + b + 64), a2);
+        _mm256_storeu_si256((__m256i*)(dst + b + 96), a3);
+    }
+    for (; b + 32 <= n; b += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(dst + b));
+        a = _mm256_xor_si256(a, _mm256_loadu_si256((const __m256i*)(src + b)));
+        _mm256_storeu_si256((__m256i*)(dst + b), a);
+    }
+    xor_portable(dst + b, src + b, n - b);
+}
+
+AURORA_TARGET("avx512f")
+inline void xor_avx512(uint8_t* dst, const uint8_t* src, size_t n) {
+    size_t b = xor_align_head(dst, src, n, 64);
+    for (; b + 128 <= n; b += 128) {
+        __m512i a0 = _mm512_loadu_si512((const void*)(dst + b));
+        __m512i a1 = _mm512_loadu_si512((const void*)(dst + b + 64));
+        a0 = _mm512_xor_si512(a0, _mm512_loadu_si512((const void*)(src + b)));
+        a1 = _mm512_xor_si512(a1, _mm512_loadu_si512((const void*)(src + b + 64)));
+        _mm512_storeu_si512((void*)(dst + b), a0);
+        _mm512_storeu_si512((void*)(dst + b + 64), a1);
+    }
+    for (; b + 64 <= n; b += 64) {
+        __m512i a = _mm512_loadu_si512((const void*)(dst + b));
+        a = _mm512_xor_si512(a, _mm512_loadu_si512((const void*)(src + b)));
+        _mm512_storeu_si512((void*)(dst + b), a);
+    }
+    xor_portable(dst + b, src + b, n - b);
+}
+
+template<size_t N>
+AURORA_TARGET("sse2")
+inline void xor_fixed_sse2(uint8_t* dst, const uint8_t* src, size_t) {
+    static_assert(N % 64 == 0, "xor_fixed: N multiplo di 64");
+    AURORA_UNROLL
+    for (size_t b = 0; b < N; b += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(dst + b));
+        _mm_storeu_si128((__m128i*)(dst + b), _mm_xor_si128(a, _mm_loadu_si128((const __m128i*)(src + b))));
+    }
+}
+
+template<size_t N>
+AURORA_TARGET("avx2")
+inline void xor_fixed_avx2(uint8_t* dst, const uint8_t* src, size_t) {
+    static_assert(N % 64 == 0, "xor_fixed: N multiplo di 64");
+    if ((uintptr_t)dst & 31) { xor_avx2(dst, src, N); return; }   // vedi xor_align_head
+    AURORA_UNROLL
+    for (size_t b = 0; b < N; b += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(dst + b));
+        _mm256_storeu_si256((__m256i*)(dst + b), _mm256_xor_si256(a, _mm256_loadu_si256((const __m256i*)(src + b))));
+    }
+}
+
+template<size_t N>
+AURORA_TARGET("avx512f")
+inline void xor_fixed_avx512(uint8_t* dst, const uint8_t* src, size_t) {
+    static_assert(N % 64 == 0, "xor_fixed: N multiplo di 64");
+    if ((uintptr_t)dst & 63) { xor_avx512(dst, src, N); return; }
+    AURORA_UNROLL
+    for (size_t b = 0; b < N; b += 64) {
+        __m512i a = _mm512_loadu_si512((const void*)(dst + b));
+        _mm512_storeu_si512((void*)(dst + b), _mm512_xor_si512(a, _mm512_loadu_si512((const void*)(src + b))));
+    }
+}
+
+// Rilevamento CPU (incluso il supporto OS per i registri YMM/ZMM)
+enum class CpuFeature { SSE2, AVX2, AVX512F };
+
+inline bool cpu_has(CpuFeature f) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int r[4];
+    __cpuid(r, 0);
+    int max_leaf = r[0];
+    __cpuid(r, 1);
+    bool sse2 = (r[3] >> 26) & 1;
+    bool osxsave = (r[2] >> 27) & 1;
+    if (f == CpuFeature::SSE2) return sse2;
+    if (!osxsave || max_leaf < 7) return false;
+    unsigned long long xcr0 = _xgetbv(0);
+    __cpuidex(r, 7, 0);
+    if (f == CpuFeature::AVX2) return ((xcr0 & 0x6) == 0x6) && ((r[1] >> 5) & 1);
+    return ((xcr0 & 0xE6) == 0xE6) && ((r[1] >> 16) & 1);
+#else
+    __builtin_cpu_init();
+    switch (f) {
+        case CpuFeature::SSE2:    return __builtin_cpu_supports("sse2");
+        case CpuFeature::AVX2:    return __builtin_cpu_supports("avx2");
+        case CpuFeature::AVX512F: return __builtin_cpu_supports("avx512f");
+    }
+    return false;
+#endif
+}
+#endif // AURORA_XOR_X86
+
+struct XorKernel {
+    const char* name;
+    XorFn fn;
+    bool supported;
+};
+
+// Tutte le varianti compilate, dalla piu' semplice alla piu' larga
+inline const std::vector<XorKernel>& xor_kernels() {
+    static const std::vector<XorKernel> ks = [] {
+        std::vector<XorKernel> v;
+        v.push_back({"portable", &xor_portable, true});
+#ifdef AURORA_XOR_X86
+        v.push_back({"sse2", &xor_sse2, cpu_has(CpuFeature::SSE2)});
+        v.push_back({"avx2", &xor_avx2, cpu_has(CpuFeature::AVX2)});
+        v.push_back({"avx512", &xor_avx512, cpu_has(CpuFeature::AVX512F)});
+#endif
+        return v;
+    }();
+    return ks;
+}
+
+// Variante piu' larga supportata (o quella forzata da AURORA_XOR_KERNEL)
+inline const XorKernel& xor_selected() {
+    static const XorKernel* sel = [] {
+        const auto& ks = xor_kernels();
+        const XorKernel* best = &ks.front();
+        for (const auto& k : ks) if (k.supported) best = &k;
+        const char* env = std::getenv("AURORA_XOR_KERNEL");
+        if (env && *env) {
+            for (const auto& k : ks) if (k.supported && std::string(env) == k.name) best = &k;
+        }
+        return best;
+    }();
+    return *sel;
+}
+
+inline void xor_into(uint8_t* dst, const uint8_t* src, size_t n) {
+    static const XorFn fn = xor_selected().fn;
+    fn(dst, src, n);
+}
+
+// Dimensioni simbolo con kernel dedicato (le scelte di AlienFountainOrganism::symbol_size_for)
+constexpr size_t FIXED_SIZES[] = {64, 128, 256, 512, 1024};
+
+// Kernel a dimensione N della variante `name` (portabile se la variante non ne ha)
+template<size_t N>
+inline XorFn xor_fixed_variant(const std::string& name) {
+#ifdef AURORA_XOR_X86
+    if (name == "sse2") return &xor_fixed_sse2<N>;
+    if (name == "avx2") return &xor_fixed_avx2<N>;
+    if (name == "avx512") return &xor_fixed_avx512<N>;
+#endif
+    (void)name;
+    return &xor_fixed_portable<N>;
+}
+
+inline bool xor_fixed_enabled() {
+    static const bool on = [] {
+        const char* env = std::getenv("AURORA_XOR_FIXED");
+        return !(env && std::string(env) == "0");
+    }();
+    return on;
+}
+
+// Kernel per simboli da n byte: quello a dimensione fissa della variante selezionata se n e'
+// in FIXED_SIZES, altrimenti il generico. Da chiamare sempre con n byte.
+inline XorFn xor_for(size_t n) {
+    const XorKernel& k = xor_selected();
+    if (!xor_fixed_enabled()) return k.fn;
+    switch (n) {
+        case 64:   return xor_fixed_variant<64>(k.name);
+        case 128:  return xor_fixed_variant<128>(k.name);
+        case 256:  return xor_fixed_variant<256>(k.name);
+        case 512:  return xor_fixed_variant<512>(k.name);
+        case 1024: return xor_fixed_variant<1024>(k.name);
+        default:   return k.fn;
+    }
+}
+
+// dst ^= src su N byte (N multiplo di 64): con la ISA garantita dal build (-mavx2 ...) il
+// kernel e' chiamato direttamente e si inline, altrimenti la variante scelta a runtime
+template<size_t N>
+inline void xor_fixed(uint8_t* dst, const uint8_t* src) {
+#if defined(__AVX512F__)
+    xor_fixed_avx512<N>(dst, src, N);
+#elif defined(__AVX2__)
+    xor_fixed_avx2<N>(dst, src, N);
+#else
+    static const XorFn fn = xor_fixed_variant<N>(xor_selected().name);
+    fn(dst, src, N);
+#endif
+}
+
+} // namespace simd
+} // namespace fec
@@ -0,0 +1,15 @@
+// aurora_test_check.hpp
+// CHECK dei test: controllo sempre attivo, anche nelle build Release (NDEBUG), a differenza
+// di assert(). Stampa file, riga e condizione fallita ed esce con abort()
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+#define CHECK(cond)                                                                          \
+    do {                                                                                     \
+        if (!(cond)) {                                                                       \
+            std::fprintf(stderr, "%s:%d: CHECK fallito: %s\n", __FILE__, __LINE__, #cond);    \
+            std::abort();                                                                    \
+        }                                                                                    \
+    } while (0)
@@ -0,0 +1,223 @@
+// test_aurora_embedded.cpp
+// Test della configurazione embedded (AURORA_EMBEDDED, StaticOrganism<KMAX, S, TOKENS>):
+// 1. Zero allocazioni: spawn/integrate con perdite per ogni FlowClass, operator new contato
+// 2. Slot token: piu' token intrecciati, slot liberato dal token piu' vecchio
+// 3. Memoria immunitaria: fallimento -> overhead e panic_boost crescono, piu' pacchetti allo spawn
+// 4. Footprint: sizeof esatto di organismo, decoder e pacchetto per alcune (K_max, S)
+//
+// Build: cmake --build build --target test_aurora_embedded
+// Run: ./build/bin/test_aurora_embedded
+
+#ifndef AURORA_EMBEDDED
+#define AURORA_EMBEDDED 1
+#endif
+#include "../aurora_organism.hpp"
+#include "aurora_test_check.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+
+using namespace aurora;
+using namespace std;
+
+// ============================================================================
+// Contatore di allocazioni: ogni operator new globale passa di qui
+static size_t g_allocs = 0;
+
+static void* counted_alloc(size_t n, size_t align = 0) {
+    ++g_allocs;
+    void* p = align ? std::aligned_alloc(align, (n + align - 1) / align * align) : std::malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t n) { return counted_alloc(n); }
+void* operator new[](size_t n) { return counted_alloc(n); }
+void* operator new(size_t n, std::align_val_t a) { return counted_alloc(n, (size_t)a); }
+void* operator new[](size_t n, std::align_val_t a) { return counted_alloc(n, (size_t)a); }
+void* operator new(size_t n, const std::nothrow_t&) noexcept { ++g_allocs; return std::malloc(n ? n : 1); }
+void* operator new[](size_t n, const std::nothrow_t&) noexcept { ++g_allocs; return std::malloc(n ? n : 1); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+// ============================================================================
+using Org = embedded::StaticOrganism<64, 128, 2>;
+constexpr size_t TX_MAX = 1024, RX_MAX = 4096;
+
+// Buffer statici: niente heap anche per il "canale" del test
+static Org g_tx, g_rx;
+static Org::Pkt g_spawn[TX_MAX], g_wire[RX_MAX];
+static uint8_t g_payload[Org::MAX_PAYLOAD], g_out[Org::MAX_PAYLOAD];
+
+static void fill_payload(size_t len, uint32_t seed) {
+    std::mt19937 rng(seed);
+    for (size_t i = 0; i < len; ++i) g_payload[i] = (uint8_t)rng();
+}
+
+static const char* class_name(FlowClass c) {
+    return c == FlowClass::NERVE ? "NERVE" : c == FlowClass::GLAND ? "GLAND" : "MUSCLE";
+}
+
+// ============================================================================
+// TEST 1: spawn/integrate con perdite, nessuna allocazione
+// ============================================================================
+void test_no_heap() {
+    std::cout << "--- Zero allocazioni su spawn/integrate ---" << std::endl;
+    std::mt19937 rng(7);
+    int tok = 0;
+    for (FlowClass cls : {FlowClass::NERVE, FlowClass::MUSCLE, FlowClass::GLAND}) {
+        for (size_t len : {size_t(40), size_t(300), size_t(2000), Org::MAX_PAYLOAD}) {
+            fill_payload(len, (uint32_t)len);
+            char id[16];
+            std::snprintf(id, sizeof(id), "tok-%d", tok++);
+
+            const size_t before = g_allocs;
+            size_t wire = 0, rounds = 0;
+            embedded::StaticIntegrateResult r;
+            // 15% di perdita; se il token non e' completo il mittente rispawna (repair nuovi)
+            while (!r.delivered && rounds++ < 8) {
+                size_t n = g_tx.spawn(cls, id, g_payload, len, g_spawn, TX_MAX);
+                CHECK(n >= (len + 127) / 128);
+                for (size_t i = 0; i < n && wire < RX_MAX; ++i)
+                    if (rng() % 100 >= 15) g_wire[wire++] = g_spawn[i];
+                r = g_rx.integrate(cls, id, g_wire, wire, g_out);
+            }
+            const size_t allocs = g_allocs - before;
+
+            CHECK(allocs == 0);
+            CHECK(r.delivered && r.coverage >= 1.0 && r.payload_size == len && r.payload_len == len);
+            CHECK(std::memcmp(g_out, g_payload, len) == 0);
+            std::cout << "  " << class_name(cls) << " " << len << " byte: " << rounds << " round, "
+                      << r.symbols_used << "/" << r.total_symbols_seen << " simboli, 0 allocazioni ✓" << std::endl;
+        }
+    }
+    // payload oltre la capacita': rifiutato senza scrivere pacchetti
+    const size_t before = g_allocs;
+    const size_t n_big = g_tx.spawn(FlowClass::MUSCLE, "big", g_payload, Org::MAX_PAYLOAD + 1, g_spawn, TX_MAX);
+    const size_t count_big = g_tx.spawn_count(FlowClass::MUSCLE, Org::MAX_PAYLOAD + 1);
+    CHECK(n_big == 0 && count_big == 0);
+    CHECK(g_allocs == before);
+    std::cout << "  payload > " << Org::MAX_PAYLOAD << " byte rifiutato ✓" << std::endl;
+}
+
+// ============================================================================
+// TEST 2: token intrecciati e riuso degli slot
+// ============================================================================
+void test_token_slots() {
+    std::cout << "--- Slot dei token ---" << std::endl;
+    static Org rx;
+    static Org::Pkt a[TX_MAX], b[TX_MAX];
+    const size_t before = g_allocs;
+
+    fill_payload(1500, 11);
+    size_t na = g_tx.spawn(FlowClass::MUSCLE, "alpha", g_payload, 1500, a, TX_MAX);
+    fill_payload(900, 12);
+    size_t nb = g_tx.spawn(FlowClass::MUSCLE, "beta", g_payload, 900, b, TX_MAX);
+
+    // Pacchetti intrecciati nello stesso buffer: ogni token prende solo i suoi
+    size_t wire = 0;
+    for (size_t i = 0; i < std::max(na, nb); ++i) {
+        if (i < na) g_wire[wire++] = a[i];
+        if (i < nb) g_wire[wire++] = b[i];
+    }
+    auto ra = rx.integrate(FlowClass::MUSCLE, "alpha", g_wire, wire / 2);
+    auto rb = rx.integrate(FlowClass::MUSCLE, "beta", g_wire, wire / 2);
+    CHECK(!ra.delivered && !rb.delivered && rx.active_tokens() == 2);
+
+    // Terzo token con due slot: si libera quello usato meno di recente (alpha)
+    auto rc = rx.integrate(FlowClass::MUSCLE, "gamma", g_wire, wire);
+    CHECK(rc.total_symbols_seen == 0 && rx.active_tokens() == 2);
+
+    rb = rx.integrate(FlowClass::MUSCLE, "beta", g_wire, wire, g_out);
+    CHECK(rb.delivered && std::memcmp(g_out, g_payload, 900) == 0);
+    // alpha riparte da capo sul buffer intero
+    ra = rx.integrate(FlowClass::MUSCLE, "alpha", g_wire, wire, g_out);
+    fill_payload(1500, 11);
+    CHECK(ra.delivered && std::memcmp(g_out, g_payload, 1500) == 0);
+    CHECK(g_allocs == before);
+    std::cout << "  2 slot, 3 token: beta consegnato, alpha riaperto e consegnato ✓" << std::endl;
+}
+
+// ============================================================================
+// TEST 3: memoria immunitaria
+// ============================================================================
+void test_adaptation() {
+    std::cout << "--- Memoria immunitaria ---" << std::endl;
+    static Org org;
+    const FlowClass cls = FlowClass::GLAND;
+    const size_t len = 3000;
+    fill_payload(len, 21);
+
+    const auto st0 = org.flow_state(cls);
+    const size_t n0 = org.spawn_count(cls, len);
+    size_t n = org.spawn(cls, "weak", g_payload, len, g_spawn, TX_MAX);
+    CHECK(n == n0);
+
+    // Arriva meno di K: fallimento
+    auto r = org.integrate(cls, "weak", g_spawn, (len + 127) / 128 / 2);
+    CHECK(!r.delivered && r.coverage > 0.0 && r.coverage < 1.0);
+    CHECK(r.payload_len > 0);   // prefisso critico gia' ricostruito dai sorgenti in chiaro
+    const auto& st = org.flow_state(cls);
+    CHECK(st.fail_count == 1 && st.panic_boost == Org::PANIC_BOOST_STEPS);
+    CHECK(st.crit_overhead > st0.crit_overhead && st.bulk_overhead > st0.bulk_overhead);
+    const size_t n1 = org.spawn_count(cls, len);
+    CHECK(n1 > n0);
+    std::cout << "  GLAND: crit_ov " << st0.crit_overhead << " -> " << st.crit_overhead
+              << ", pacchetti " << n0 << " -> " << n1 << " ✓" << std::endl;
+}
+
+// ============================================================================
+// TEST 4: RAM per configurazione
+// ============================================================================
+template<size_t KMAX, size_t S, size_t TOKENS = 1>
+static void report_footprint() {
+    using O = embedded::StaticOrganism<KMAX, S, TOKENS>;
+    constexpr size_t dec = sizeof(embedded::StaticDecoder<KMAX, S>);
+    constexpr size_t crit = sizeof(embedded::StaticDecoder<O::CRIT_K, S>);
+    static_assert(sizeof(O) >= TOKENS * (dec + crit));
+    static_assert(dec >= KMAX * S + KMAX * KMAX / 8);
+    std::printf("  K_max=%-4zu S=%-4zu token=%zu  organismo %8zu B  (decoder bulk %zu B, critico %zu B, pkt %zu B)\n",
+                KMAX, S, TOKENS, sizeof(O), dec, crit, sizeof(typename O::Pkt));
+}
+
+void test_footprint() {
+    std::cout << "--- Footprint RAM ---" << std::endl;
+    report_footprint<16, 64>();
+    report_footprint<32, 128>();
+    report_footprint<64, 128>();
+    report_footprint<64, 256>();
+    report_footprint<128, 256>();
+    report_footprint<256, 512>();
+    report_footprint<Org::CRIT_K, 128, 4>();
+    std::printf("  EmbeddedOrganism (K_max=%d S=%d token=%d): %zu B ✓\n", AURORA_EMBEDDED_KMAX,
+                AURORA_EMBEDDED_SYMBOL, AURORA_EMBEDDED_TOKENS, sizeof(EmbeddedOrganism));
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+int main() {
+    std::cout << string(70, '=') << std::endl;
+    std::cout << "TEST ORGANISMO EMBEDDED (no heap)" << std::endl;
+    std::cout << string(70, '=') << std::endl;
+
+    test_no_heap();
+    test_token_slots();
+    test_adaptation();
+    test_footprint();
+
+    std::cout << string(70, '=') << std::endl;
+    std::cout << "TUTTI I TEST EMBEDDED COMPLETATI CON SUCCESSO!" << std::endl;
+    std::cout << string(70, '=') << std::endl;
+    return 0;
+}
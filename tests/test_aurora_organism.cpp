@@ -1,8 +1,14 @@
 // test_aurora_organism.cpp
 // Test completo per AlienFountainOrganism con tre scenari:
 // 1. Canale buono: NERVE, GLAND, MUSCLE con delivery=true, overhead stabili
-// 2. Canale cattivo: NERVE/GLAND con perdite, panic_boost, overhead crescenti
+// 2. Canale cattivo: NERVE/GLAND con perdite, recupero parziale, panic_boost, overhead crescenti
 // 3. Adattamento: GLAND che si adatta da canale cattivo a buono
+// 4. Streaming NERVE: finestra scorrevole, consegna in ordine con perdite
+// 5. Dimensione simbolo: scelta per flusso/payload/perdita, trasportata nei pacchetti
+// 6. Token concorrenti: centinaia di token in volo, geometria per token, reintegrate dopo la consegna e scadenza dei contesti
+// 7. Thread concorrenti: spawn/integrate da piu' thread, stato adattivo per (classe, priorita')
+// 8. Strati UEP: header/indice/corpo con importanze diverse, rilascio progressivo sotto perdite
+// 9. Consegna anticipata: callback per critico e blocchi del bulk appena decodificati
 //
 // Build: cmake --build build --target test_aurora_organism
 // Run: ./build/bin/Release/test_aurora_organism.exe
@@ -10,6 +16,7 @@
 #include "../aurora_organism.hpp"
 #include "../aurora_intention.hpp"
 #include "../aurora_extreme.hpp"
+#include "aurora_test_check.hpp"
 #include <iostream>
 #include <iomanip>
 #include <vector>
@@ -18,6 +25,9 @@
 #include <cassert>
 #include <map>
 #include <string>
+#include <stdexcept>
+#include <thread>
+#include <functional>
 
 using namespace aurora;
 using namespace std;
@@ -246,6 +256,10 @@ void test_scenario_bad_channel() {
         
         assert(integrate_res.delivered == false);
         assert(integrate_res.coverage < 0.9);  // Coverage incompleto per perdite elevate
+        // recupero parziale: coverage al byte e prefisso gia' ricostruito consegnato
+        assert(integrate_res.coverage > 0.0);
+        assert(integrate_res.payload_bytes.size() <= payload.size());
+        assert(std::equal(integrate_res.payload_bytes.begin(), integrate_res.payload_bytes.end(), payload.begin()));
         std::cout << "  ✓ NERVE fallito come previsto (delivered=false)\n" << std::endl;
         
         // Secondo spawn: dovrebbe vedere panic_boost attivo
@@ -286,6 +300,10 @@ void test_scenario_bad_channel() {
         
         assert(integrate_res.delivered == false);
         assert(integrate_res.coverage < 0.9);
+        // recupero parziale: coverage al byte e prefisso gia' ricostruito consegnato
+        assert(integrate_res.coverage > 0.0);
+        assert(integrate_res.payload_bytes.size() <= payload.size());
+        assert(std::equal(integrate_res.payload_bytes.begin(), integrate_res.payload_bytes.end(), payload.begin()));
         std::cout << "  ✓ GLAND fallito come previsto (delivered=false)\n" << std::endl;
         
         // Secondo spawn: dovrebbe vedere panic_boost attivo
@@ -441,6 +459,483 @@ void test_scenario_adaptation() {
     std::cout << "✓ SCENARIO 3 COMPLETATO: adattamento nel tempo testato\n" << std::endl;
 }
 
+// ============================================================================
+// SCENARIO 4: STREAMING NERVE (FINESTRA SCORREVOLE)
+// ============================================================================
+void test_scenario_nerve_stream() {
+    std::cout << "\n" << string(70, '=') << std::endl;
+    std::cout << "SCENARIO 4: STREAMING NERVE" << std::endl;
+    std::cout << string(70, '=') << std::endl;
+    std::cout << "Flusso continuo di messaggi piccoli, perdita 15%:" << std::endl;
+    std::cout << "ogni messaggio consegnato in ordine appena ricostruibile\n" << std::endl;
+    
+    AlienFountainOrganism tx, rx;
+    Intention I = make_intention_for_flow(FlowClass::NERVE);
+    FlowProfile profile = tx.build_profile(I);
+    CHECK(profile.flow_class == FlowClass::NERVE);
+    
+    const int NUM_MSGS = 2000;
+    const size_t S = 64;
+    std::mt19937 rng(77);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    std::vector<std::vector<uint8_t>> sent;
+    uint32_t next = 0;
+    int delivered = 0, lost = 0, immediate = 0, symbols = 0;
+    
+    for (int i = 0; i < NUM_MSGS; ++i) {
+        sent.push_back(generate_payload(1 + i % (S - 2), 500 + i));
+        for (const auto& sym : tx.stream_send(profile, "nerve_stream", sent.back(), S)) {
+            ++symbols;
+            if (dist(rng) < 0.15) continue;
+            for (const auto& d : rx.stream_receive("nerve_stream", sym, S)) {
+                CHECK(d.seq == next);
+                ++next;
+                if (d.lost) { ++lost; continue; }
+                CHECK(d.bytes == sent[d.seq]);
+                ++delivered;
+                if (d.seq == (uint32_t)i) ++immediate;   // consegnato con il simbolo del suo turno
+            }
+        }
+    }
+    
+    std::cout << "  messaggi=" << NUM_MSGS << " simboli=" << symbols
+              << " consegnati=" << delivered << " persi=" << lost
+              << " senza attesa=" << immediate << std::endl;
+    // NERVE ha crit_overhead 2.0: un repair per messaggio basta a recuperare tutto
+    CHECK(lost == 0 && delivered >= NUM_MSGS - 1);
+    CHECK(immediate > NUM_MSGS / 2);
+    
+    // Messaggio oltre il simbolo: rifiutato
+    bool thrown = false;
+    try {
+        tx.stream_send(profile, "nerve_stream", std::vector<uint8_t>(S - 1), S);
+    } catch (const std::length_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    
+    std::cout << "✓ SCENARIO 4 COMPLETATO: streaming NERVE in ordine\n" << std::endl;
+}
+
+// ============================================================================
+// SCENARIO 5: DIMENSIONE SIMBOLO
+// ============================================================================
+void test_scenario_symbol_size() {
+    std::cout << "\n" << string(70, '=') << std::endl;
+    std::cout << "SCENARIO 5: DIMENSIONE SIMBOLO" << std::endl;
+    std::cout << string(70, '=') << std::endl;
+    std::cout << "Costo: decodifica calibrata + energia per pacchetto + perdita attesa\n" << std::endl;
+    
+    AlienFountainOrganism tx;
+    auto is_candidate = [](size_t S) {
+        for (size_t c : AlienFountainOrganism::SYMBOL_SIZES) if (c == S) return true;
+        return false;
+    };
+    for (FlowClass cls : {FlowClass::NERVE, FlowClass::GLAND, FlowClass::MUSCLE}) {
+        FlowProfile profile = tx.build_profile(make_intention_for_flow(cls));
+        std::cout << "  " << (cls == FlowClass::NERVE ? "NERVE " : cls == FlowClass::GLAND ? "GLAND " : "MUSCLE");
+        for (size_t n : {200, 4096, 1 << 20}) {
+            size_t clean = tx.symbol_size_for(profile, n, 0.01);
+            size_t lossy = tx.symbol_size_for(profile, n, 0.3);
+            std::cout << "  " << n << "B: " << clean << "/" << lossy;
+            CHECK(is_candidate(clean) && is_candidate(lossy));
+            // frame piu' lunghi si perdono piu' spesso: con piu' perdita il simbolo non cresce
+            CHECK(lossy <= clean);
+        }
+        std::cout << "  (perdita 1%/30%)" << std::endl;
+    }
+    FlowProfile muscle = tx.build_profile(make_intention_for_flow(FlowClass::MUSCLE));
+    // payload grande: il costo fisso per pacchetto e la decodifica spingono verso simboli grandi
+    size_t big = tx.symbol_size_for(muscle, 1 << 20, 0.01), small = tx.symbol_size_for(muscle, 1024, 0.01);
+    CHECK(big >= small);
+    
+    // Spawn senza symbol_size: la scelta viaggia nei Pkt e il ricevitore decodifica con quella
+    std::vector<uint8_t> payload = generate_payload(64 * 1024, 900);
+    size_t chosen = tx.symbol_size_for(muscle, payload.size());
+    OrganismSpawnResult spawn_res = tx.spawn(muscle, "muscle_auto_001", payload);
+    for (const auto& p : spawn_res.packets) CHECK(p.sym == chosen && p.fp.data.size() == chosen);
+    OrganismIntegrateResult res = tx.integrate(muscle, "muscle_auto_001", spawn_res.K, 0, spawn_res.packets);
+    // payload_bytes: critico senza il padding del suo ultimo simbolo, poi il bulk
+    CHECK(res.delivered && res.payload_bytes == payload);
+    std::cout << "  spawn automatico: S=" << chosen << " K=" << spawn_res.K
+              << " pacchetti=" << spawn_res.packets.size() << " ✓" << std::endl;
+    std::cout << "\n✓ SCENARIO 5 COMPLETATO\n" << std::endl;
+}
+
+// ============================================================================
+// SCENARIO 6: TOKEN CONCORRENTI
+// ============================================================================
+void test_scenario_concurrent_tokens() {
+    std::cout << "\n" << string(70, '=') << std::endl;
+    std::cout << "SCENARIO 6: TOKEN CONCORRENTI" << std::endl;
+    std::cout << string(70, '=') << std::endl;
+    std::cout << "Tutti gli spawn prima di ogni integrate, pacchetti intrecciati e con perdite\n" << std::endl;
+    
+    AlienFountainOrganism org;
+    const size_t S = 128;
+    const int TOKENS = 200;
+    struct InFlight {
+        std::string id;
+        FlowProfile profile;
+        std::vector<uint8_t> payload;
+        std::vector<OrganismSpawnResult> spawns;   // i Pkt ricevuti puntano nelle loro slab
+        std::vector<fec::Pkt> received;
+        bool done = false;
+    };
+    std::vector<InFlight> tokens(TOKENS);
+    for (int t = 0; t < TOKENS; ++t) {
+        InFlight& f = tokens[t];
+        f.id = "conc_" + std::to_string(t);
+        f.profile = org.build_profile(make_intention_for_flow(t % 2 ? FlowClass::GLAND : FlowClass::MUSCLE));
+        f.payload = generate_payload(100 + 97 * (size_t)t, 600 + t);   // ogni token con la sua geometria
+        f.spawns.push_back(org.spawn(f.profile, f.id, f.payload, S));
+    }
+    CHECK(org.active_tokens() == TOKENS);
+    
+    // Canale: pacchetti di tutti i token intrecciati, 5% di perdita
+    std::mt19937 rng(66);
+    std::uniform_real_distribution<double> loss(0.0, 1.0);
+    std::vector<std::pair<int, fec::Pkt>> air;
+    auto transmit = [&](size_t from, size_t to) {
+        for (size_t i = from; i < to; ++i)
+            if (loss(rng) >= 0.05) tokens[air[i].first].received.push_back(air[i].second);
+    };
+    for (int t = 0; t < TOKENS; ++t)
+        for (const auto& p : tokens[t].spawns.back().packets) air.push_back({t, p});
+    std::shuffle(air.begin(), air.end(), rng);
+    
+    // Round 0: meta' del canale, round 1: il resto, integrate dall'ultimo token al primo.
+    // Poi i token incompleti rispawnano: stessa geometria, il contesto tiene i simboli ricevuti
+    int delivered = 0;
+    for (int round = 0; round < 6 && delivered < TOKENS; ++round) {
+        if (round < 2) {
+            transmit(round * air.size() / 2, round ? air.size() : air.size() / 2);
+        } else {
+            air.clear();
+            for (int t = 0; t < TOKENS; ++t) {
+                if (tokens[t].done) continue;
+                tokens[t].spawns.push_back(org.spawn(tokens[t].profile, tokens[t].id, tokens[t].payload, S));
+                for (const auto& p : tokens[t].spawns.back().packets) air.push_back({t, p});
+            }
+            std::shuffle(air.begin(), air.end(), rng);
+            transmit(0, air.size());
+        }
+        for (int t = TOKENS - 1; t >= 0; --t) {
+            InFlight& f = tokens[t];
+            if (f.done) continue;
+            // K_hint sbagliato di proposito: la geometria viene dal contesto del token
+            OrganismIntegrateResult res = org.integrate(f.profile, f.id, 1, 0, f.received);
+            if (!res.delivered) continue;
+            CHECK(res.payload_bytes == f.payload);
+            f.done = true;
+            ++delivered;
+        }
+        std::cout << "  round " << round << ": " << delivered << "/" << TOKENS << " token consegnati" << std::endl;
+    }
+    CHECK(delivered == TOKENS);
+    
+    // Token gia' consegnato: integrate() rende lo stesso payload senza contare un altro successo
+    {
+        InFlight& f = tokens[0];
+        FlowState before = org.flow_state(f.profile.flow_class, f.profile.priority);
+        OrganismIntegrateResult again = org.integrate(f.profile, f.id, 1, 0, f.received);
+        FlowState after = org.flow_state(f.profile.flow_class, f.profile.priority);
+        CHECK(again.delivered && again.coverage >= 1.0 && again.payload_bytes == f.payload);
+        CHECK(after.success_count == before.success_count && after.good_streak == before.good_streak);
+        std::cout << "  reintegrate dopo la consegna: stesso payload, FlowState invariato ✓" << std::endl;
+    }
+    
+    // Scadenza: tabella limitata a 32 contesti, poi inattivi per piu' di 64 chiamate
+    org.set_token_expiry(32, 64);
+    std::vector<uint8_t> small = generate_payload(300, 777);
+    FlowProfile muscle = org.build_profile(make_intention_for_flow(FlowClass::MUSCLE));
+    org.spawn(muscle, "late_0", small, S);
+    CHECK(org.active_tokens() == 32);
+    for (int i = 1; i <= 70; ++i) org.spawn(muscle, "late_" + std::to_string(i % 2), small, S);
+    CHECK(org.active_tokens() == 2);
+    std::cout << "  scadenza: 32 contesti al massimo, inattivi rimossi dopo 64 chiamate ✓" << std::endl;
+    
+    // Il limite vale per tutta la tabella, non per shard: 64 token restano tutti anche se gli
+    // shard sono sbilanciati, e un limite sotto il numero di shard non lascia un contesto per shard
+    AlienFountainOrganism capped;
+    capped.set_token_expiry(64, 1 << 20);
+    for (int i = 0; i < 64; ++i) capped.spawn(muscle, "cap_" + std::to_string(i), small, S);
+    CHECK(capped.active_tokens() == 64);
+    capped.spawn(muscle, "cap_64", small, S);
+    CHECK(capped.active_tokens() == 64);
+    capped.set_token_expiry(3, 1 << 20);
+    CHECK(capped.active_tokens() == 3);
+    for (int i = 0; i < 20; ++i) capped.spawn(muscle, "cap_more_" + std::to_string(i), small, S);
+    CHECK(capped.active_tokens() == 3);
+    std::cout << "  limite globale: 64 contesti su 16 shard, poi 3 ✓" << std::endl;
+    std::cout << "\n✓ SCENARIO 6 COMPLETATO\n" << std::endl;
+}
+
+// ============================================================================
+// SCENARIO 7: THREAD CONCORRENTI
+// ============================================================================
+void test_scenario_threads() {
+    std::cout << "\n" << string(70, '=') << std::endl;
+    std::cout << "SCENARIO 7: THREAD CONCORRENTI" << std::endl;
+    std::cout << string(70, '=') << std::endl;
+    std::cout << "Un flusso per thread, spawn/integrate in parallelo sullo stesso organismo\n" << std::endl;
+    
+    // Indici della tabella: uno per (classe, priorita'), tutti distinti
+    std::vector<bool> seen(FlowStateTable<false>::SIZE, false);
+    for (FlowClass c : {FlowClass::NERVE, FlowClass::MUSCLE, FlowClass::GLAND}) {
+        for (Priority p : {Priority::CRITICAL, Priority::NORMAL, Priority::BULK}) {
+            size_t i = FlowStateTable<false>::index(c, p);
+            CHECK(i < seen.size() && !seen[i]);
+            seen[i] = true;
+        }
+    }
+    
+    AlienFountainOrganism org;
+    const size_t S = 128;
+    const int PER_THREAD = 25;
+    // MUSCLE due volte con priorita' diverse: stessa classe, voci separate
+    const std::vector<std::pair<FlowClass, double>> flows = {
+        {FlowClass::NERVE, 0.99}, {FlowClass::MUSCLE, 0.90}, {FlowClass::GLAND, 0.98}, {FlowClass::MUSCLE, 0.50}};
+    std::vector<FlowProfile> profiles;
+    for (const auto& [cls, rel] : flows) {
+        Intention I = make_intention_for_flow(cls);
+        I.reliability = rel;
+        profiles.push_back(org.build_profile(I));
+    }
+    CHECK(profiles[1].priority == Priority::NORMAL && profiles[3].priority == Priority::BULK);
+    
+    std::vector<int> delivered(flows.size(), 0);
+    std::vector<std::thread> workers;
+    for (size_t w = 0; w < flows.size(); ++w) {
+        workers.emplace_back([&, w] {
+            for (int t = 0; t < PER_THREAD; ++t) {
+                std::string id = "thr_" + std::to_string(w) + "_" + std::to_string(t);
+                std::vector<uint8_t> payload = generate_payload(200 + 53 * (size_t)t, 900 + (uint32_t)(w * 100 + t));
+                OrganismSpawnResult sp = org.spawn(profiles[w], id, payload, S);
+                OrganismIntegrateResult res = org.integrate(profiles[w], id, sp.K, 0, sp.packets);
+                if (res.delivered && res.payload_bytes == payload) ++delivered[w];
+            }
+        });
+    }
+    for (auto& th : workers) th.join();
+    
+    for (size_t w = 0; w < flows.size(); ++w) {
+        CHECK(delivered[w] == PER_THREAD);
+        FlowState st = org.flow_state(profiles[w].flow_class, profiles[w].priority);
+        CHECK(st.initialized && st.age == PER_THREAD);
+        CHECK(st.success_count == PER_THREAD && st.fail_count == 0);
+        std::cout << "  " << profiles[w].flow_class << "/" << profiles[w].priority << ": "
+                  << delivered[w] << "/" << PER_THREAD << " consegnati, successi=" << st.success_count << " ✓" << std::endl;
+    }
+    CHECK(org.active_tokens() == flows.size() * PER_THREAD);
+    std::cout << "\n✓ SCENARIO 7 COMPLETATO\n" << std::endl;
+}
+
+// ============================================================================
+// SCENARIO 8: STRATI UEP
+// ============================================================================
+void test_scenario_layers() {
+    std::cout << "\n" << string(70, '=') << std::endl;
+    std::cout << "SCENARIO 8: STRATI UEP" << std::endl;
+    std::cout << string(70, '=') << std::endl;
+    std::cout << "MUSCLE da 48 KB: header (importanza 0), indice (1), corpo implicito, 10% di perdita\n" << std::endl;
+    
+    AlienFountainOrganism org;
+    const size_t S = 256;
+    FlowProfile profile = org.build_profile(make_intention_for_flow(FlowClass::MUSCLE));
+    std::vector<uint8_t> payload = generate_payload(48 * 1024, 808);
+    const std::vector<PayloadLayer> layers = {{0, 256, 0}, {256, 4096, 1}};
+    
+    // Geometria: buchi e coda in strati impliciti, sovrapposizioni rifiutate
+    auto geo = AlienFountainOrganism::layer_geometry({{1000, 100, 2}}, 2000);
+    CHECK(geo.size() == 3 && geo[0].importance == LAYER_LEVELS - 1 && geo[1].offset == 1000 && geo[2].length == 900);
+    bool threw = false;
+    try { AlienFountainOrganism::layer_geometry({{0, 100, 0}, {50, 100, 1}}, 2000); } catch (const std::invalid_argument&) { threw = true; }
+    CHECK(threw);
+    
+    // Canale in ordine di spawn, 10% di perdita; il ricevitore integra ogni 16 pacchetti arrivati.
+    // Finiti i pacchetti senza consegna, il mittente rispawna (repair nuovi); i round gia'
+    // spawnati si riusano, cosi' un secondo ricevitore vede esattamente lo stesso canale
+    auto run = [&](AlienFountainOrganism& rx, std::vector<OrganismSpawnResult>& rounds,
+                   const std::function<OrganismSpawnResult()>& respawn, const std::string& id, bool layered,
+                   std::vector<size_t>& release_at, size_t& usable_at) {
+        std::mt19937 rng(88);
+        std::uniform_real_distribution<double> loss(0.0, 1.0);
+        std::vector<fec::Pkt> received;
+        size_t sent = 0;
+        bool done = false;
+        for (size_t round = 0; round < 8 && !done; ++round) {
+            if (round == rounds.size()) rounds.push_back(respawn());
+            const OrganismSpawnResult& sp = rounds[round];
+            for (size_t i = 0; i < sp.packets.size() && !done; ++i) {
+                ++sent;
+                if (loss(rng) >= 0.10) received.push_back(sp.packets[i]);
+                if (received.size() % 16 != 0 && i + 1 < sp.packets.size()) continue;
+                OrganismIntegrateResult res = layered
+                    ? rx.integrate_layered(profile, id, received, layers, payload.size())
+                    : rx.integrate(profile, id, sp.K, 0, received);
+                for (const auto& L : res.layers) {
+                    CHECK(std::equal(L.bytes.begin(), L.bytes.end(), payload.begin() + L.offset));
+                    release_at.push_back(sent);
+                }
+                // "utilizzabile": header e indice noti, cioe' i primi 4352 byte in chiaro
+                if (usable_at == 0 && res.payload_bytes.size() >= 4352 &&
+                    std::equal(payload.begin(), payload.begin() + 4352, res.payload_bytes.begin())) {
+                    usable_at = sent;
+                }
+                if (res.delivered) {
+                    CHECK(res.payload_bytes == payload);
+                    done = true;
+                }
+            }
+        }
+        CHECK(done);
+        return sent;
+    };
+    
+    std::vector<OrganismSpawnResult> rounds;
+    auto respawn = [&] { return org.spawn_layered(profile, "uep", payload, layers, S); };
+    std::vector<size_t> release_at;
+    size_t usable_layered = 0;
+    size_t total = run(org, rounds, respawn, "uep", true, release_at, usable_layered);
+    CHECK(rounds[0].packets.front().kind == fec::SegmentKind::LAYER && rounds[0].packets.front().layer == 0);
+    CHECK(release_at.size() == 3);
+    CHECK(release_at[0] < release_at[1] && release_at[1] < release_at[2]);
+    std::cout << "  strati rilasciati dopo " << release_at[0] << ", " << release_at[1] << ", " << release_at[2]
+              << " pacchetti (" << rounds.size() << " spawn, " << total << " inviati) ✓" << std::endl;
+    
+    // Ricevitore remoto: stessa geometria passata esplicitamente, stessi pacchetti
+    AlienFountainOrganism remote;
+    std::vector<size_t> remote_release;
+    size_t usable_remote = 0;
+    run(remote, rounds, respawn, "uep", true, remote_release, usable_remote);
+    CHECK(remote_release == release_at && usable_remote == usable_layered);
+    std::cout << "  ricevitore remoto con layers espliciti: stessi rilasci ✓" << std::endl;
+    
+    // Token a strati gia' consegnato: una integrate successiva non conta un altro successo
+    std::vector<fec::Pkt> all;
+    for (const auto& sp : rounds) all.insert(all.end(), sp.packets.begin(), sp.packets.end());
+    FlowState once = org.flow_state(profile.flow_class, profile.priority);
+    OrganismIntegrateResult again = org.integrate_layered(profile, "uep", all);
+    FlowState twice = org.flow_state(profile.flow_class, profile.priority);
+    CHECK(again.delivered && again.payload_bytes == payload);
+    CHECK(twice.success_count == once.success_count && twice.layer_overhead == once.layer_overhead);
+    std::cout << "  reintegrate dopo la consegna: FlowState invariato ✓" << std::endl;
+    
+    // Confronto con critico/bulk: il prefisso utile arriva molto piu' tardi
+    std::vector<OrganismSpawnResult> flat_rounds;
+    std::vector<size_t> none;
+    size_t usable_flat = 0;
+    run(org, flat_rounds, [&] { return org.spawn(profile, "flat", payload, S); }, "flat", false, none, usable_flat);
+    CHECK(usable_layered < usable_flat);
+    std::cout << "  header+indice utilizzabili dopo " << usable_layered << " pacchetti (critico/bulk: "
+              << usable_flat << ") ✓" << std::endl;
+    
+    // Memoria per livello: corpo quasi tutto perso -> sale l'overhead del suo livello, non dell'header
+    FlowState before = org.flow_state(profile.flow_class, profile.priority);
+    OrganismSpawnResult weak = org.spawn_layered(profile, "uep_weak", payload, layers, S);
+    std::vector<fec::Pkt> partial;
+    for (const auto& p : weak.packets) if (p.layer < 2) partial.push_back(p);
+    OrganismIntegrateResult res = org.integrate_layered(profile, "uep_weak", partial);
+    CHECK(!res.delivered && res.layers.size() == 2);
+    FlowState after = org.flow_state(profile.flow_class, profile.priority);
+    CHECK(after.layer_overhead[LAYER_LEVELS - 1] > before.layer_overhead[LAYER_LEVELS - 1]);
+    CHECK(after.layer_overhead[0] == before.layer_overhead[0]);
+    std::cout << "  overhead livello corpo " << before.layer_overhead[LAYER_LEVELS - 1] << " -> "
+              << after.layer_overhead[LAYER_LEVELS - 1] << ", header invariato ✓" << std::endl;
+    std::cout << "\n✓ SCENARIO 8 COMPLETATO\n" << std::endl;
+}
+
+// ============================================================================
+// SCENARIO 9: CONSEGNA ANTICIPATA
+// ============================================================================
+void test_scenario_early_delivery() {
+    std::cout << "\n" << string(70, '=') << std::endl;
+    std::cout << "SCENARIO 9: CONSEGNA ANTICIPATA" << std::endl;
+    std::cout << string(70, '=') << std::endl;
+    std::cout << "Callback per segmento: il critico prima del token, poi i blocchi del bulk\n" << std::endl;
+    
+    AlienFountainOrganism org;
+    const size_t S = 128;
+    struct Seen {
+        fec::SegmentKind kind;
+        uint32_t index;
+        size_t offset;
+        std::vector<uint8_t> bytes;
+        int step;
+    };
+    std::vector<Seen> seen;
+    int step = 0;
+    org.set_delivery_callback([&](const SegmentDelivery& seg) {
+        seen.push_back({seg.kind, seg.index, seg.offset, std::vector<uint8_t>(seg.data, seg.data + seg.length), step});
+    });
+    auto check = [&](const std::vector<uint8_t>& payload) {
+        size_t covered = 0;
+        for (const auto& x : seen) {
+            CHECK(x.offset + x.bytes.size() <= payload.size());
+            CHECK(std::equal(x.bytes.begin(), x.bytes.end(), payload.begin() + x.offset));
+            covered += x.bytes.size();
+        }
+        CHECK(covered == payload.size());   // segmenti disgiunti che coprono tutto il payload
+    };
+    
+    // NERVE con perdite: il critico (header) esce molte integrate() prima del token completo
+    FlowProfile nerve = org.build_profile(make_intention_for_flow(FlowClass::NERVE));
+    std::vector<uint8_t> payload = generate_payload(4000, 909);
+    std::vector<OrganismSpawnResult> spawns;
+    std::vector<fec::Pkt> received;
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<double> loss(0.0, 1.0);
+    int delivered_step = -1;
+    for (int round = 0; round < 8 && delivered_step < 0; ++round) {
+        spawns.push_back(org.spawn(nerve, "early", payload, S));
+        for (const auto& p : spawns.back().packets) {
+            if (loss(rng) < 0.15) continue;
+            received.push_back(p);
+            if (received.size() % 4 != 0) continue;
+            ++step;
+            if (org.integrate(nerve, "early", 0, 0, received).delivered) { delivered_step = step; break; }
+        }
+    }
+    CHECK(delivered_step > 0 && !seen.empty());
+    CHECK(seen[0].kind == fec::SegmentKind::CRITICAL && seen[0].offset == 0);
+    CHECK(seen[0].bytes.size() == AlienFountainOrganism::critical_size_for(nerve, payload.size()));
+    CHECK(seen[0].step < delivered_step);
+    check(payload);
+    // Reintegrare dopo la consegna non notifica di nuovo
+    const size_t notified = seen.size();
+    OrganismIntegrateResult again = org.integrate(nerve, "early", 0, 0, received);
+    CHECK(again.delivered && seen.size() == notified);
+    std::cout << "  NERVE: critico (" << seen[0].bytes.size() << " byte) alla integrate " << seen[0].step
+              << ", token completo alla " << delivered_step << " ✓" << std::endl;
+    
+    // MUSCLE grande: il bulk ha piu' blocchi sorgente, ognuno notificato appena completo
+    seen.clear();
+    step = 0;
+    FlowProfile muscle = org.build_profile(make_intention_for_flow(FlowClass::MUSCLE));
+    payload = generate_payload(300 * 1024, 910);
+    OrganismSpawnResult big = org.spawn(muscle, "early_big", payload, S);
+    received.clear();
+    delivered_step = -1;
+    for (size_t i = 0; i < big.packets.size() && delivered_step < 0; ++i) {
+        received.push_back(big.packets[i]);
+        if (received.size() % 512 != 0 && i + 1 < big.packets.size()) continue;
+        ++step;
+        if (org.integrate(muscle, "early_big", 0, 0, received).delivered) delivered_step = step;
+    }
+    const uint32_t blocks = fec::block_layout(payload.size() - AlienFountainOrganism::critical_size_for(muscle, payload.size()), S).Z;
+    CHECK(blocks >= 3 && seen.size() == 1 + blocks);
+    CHECK(seen[0].kind == fec::SegmentKind::CRITICAL);
+    for (uint32_t b = 0; b < blocks; ++b) {
+        CHECK(seen[1 + b].kind == fec::SegmentKind::BULK && seen[1 + b].index == b);
+    }
+    CHECK(seen[1].step < delivered_step);
+    check(payload);
+    std::cout << "  MUSCLE " << payload.size() << " byte: critico + " << blocks << " blocchi, primo blocco alla integrate "
+              << seen[1].step << " su " << delivered_step << " ✓" << std::endl;
+    std::cout << "\n✓ SCENARIO 9 COMPLETATO\n" << std::endl;
+}
+
 // ============================================================================
 // MAIN
 // ============================================================================
@@ -448,10 +943,16 @@ int main() {
     std::cout << string(70, '=') << std::endl;
     std::cout << "TEST COMPLETO - ALIEN FOUNTAIN ORGANISM" << std::endl;
     std::cout << string(70, '=') << std::endl;
-    std::cout << "\nQuesto test verifica tre scenari:" << std::endl;
+    std::cout << "\nQuesto test verifica nove scenari:" << std::endl;
     std::cout << "  1. Canale buono: NERVE, GLAND, MUSCLE con delivery=true" << std::endl;
     std::cout << "  2. Canale cattivo: NERVE/GLAND con perdite, panic_boost, overhead crescenti" << std::endl;
-    std::cout << "  3. Adattamento: GLAND che si adatta da canale cattivo a buono\n" << std::endl;
+    std::cout << "  3. Adattamento: GLAND che si adatta da canale cattivo a buono" << std::endl;
+    std::cout << "  4. Streaming NERVE: finestra scorrevole, consegna in ordine con perdite" << std::endl;
+    std::cout << "  5. Dimensione simbolo: autotuning per flusso e payload, trasportata nei pacchetti" << std::endl;
+    std::cout << "  6. Token concorrenti: contesto per token con scadenza, centinaia di token in volo" << std::endl;
+    std::cout << "  7. Thread concorrenti: spawn/integrate in parallelo, stato per (classe, priorita')" << std::endl;
+    std::cout << "  8. Strati UEP: rilascio progressivo per importanza sotto perdite" << std::endl;
+    std::cout << "  9. Consegna anticipata: callback per segmento, il critico prima del token completo\n" << std::endl;
     
     try {
         // Scenario 1: Canale buono
@@ -463,6 +964,24 @@ int main() {
         // Scenario 3: Adattamento
         test_scenario_adaptation();
         
+        // Scenario 4: Streaming NERVE
+        test_scenario_nerve_stream();
+        
+        // Scenario 5: Dimensione simbolo
+        test_scenario_symbol_size();
+        
+        // Scenario 6: Token concorrenti
+        test_scenario_concurrent_tokens();
+        
+        // Scenario 7: Thread concorrenti
+        test_scenario_threads();
+        
+        // Scenario 8: Strati UEP
+        test_scenario_layers();
+        
+        // Scenario 9: Consegna anticipata
+        test_scenario_early_delivery();
+        
         std::cout << string(70, '=') << std::endl;
         std::cout << "TUTTI I TEST COMPLETATI CON SUCCESSO!" << std::endl;
         std::cout << string(70, '=') << std::endl;
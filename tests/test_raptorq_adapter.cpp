@@ -0,0 +1,202 @@
+// test_raptorq_adapter.cpp
+// Test del codec RaptorQ-style interno (aurora::fec::AuroraRaptorQ / RqDecoder):
+// 1. Parametri: L = K+S+H, W = K+S, vicini LT distinti e nel range
+// 2. Sistematico: ESI < K sono i blocchi in chiaro, decodifica senza perdite = copia
+// 3. Perdite casuali: decodifica con sorgenti mancanti sostituite da repair
+// 4. Overhead: tasso di successo con K, K+1, K+2 simboli ricevuti
+// 5. Semantica di add()/ready(): duplicati scartati, nessun nuovo tentativo senza simboli nuovi
+//
+// Build: cmake --build build --target test_raptorq_adapter
+// Run: ./build/bin/test_raptorq_adapter
+
+#include "fec/AuroraRaptorQ.hpp"
+#include "aurora_test_check.hpp"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+using aurora::fec::AuroraRaptorQ;
+using aurora::fec::RqParams;
+
+// Helper: Genera payload casuale
+static std::vector<uint8_t> generate_payload(size_t size, uint32_t seed = 42) {
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> payload(size);
+    for (auto& b : payload) b = static_cast<uint8_t>(rng());
+    return payload;
+}
+
+// ============================================================================
+// TEST 1: PARAMETRI
+// ============================================================================
+void test_params() {
+    std::cout << "--- Parametri e vicini LT ---" << std::endl;
+    for (uint32_t K : {1u, 2u, 10u, 100u, 1000u}) {
+        const RqParams& p = RqParams::for_K(K);
+        CHECK(p.K == K);
+        CHECK(p.L == K + p.S + p.H);
+        CHECK(p.W == K + p.S && p.Wp >= p.W && p.Pp >= p.P());
+        CHECK(p.hdpc.size() == (size_t)p.H * (K + p.S));
+        CHECK(&p == &RqParams::for_K(K));   // cache
+
+        std::vector<uint32_t> idx;
+        for (uint32_t esi = 0; esi < 2000; ++esi) {
+            p.lt_indices(esi, idx);
+            CHECK(!idx.empty());
+            CHECK(std::adjacent_find(idx.begin(), idx.end()) == idx.end());
+            CHECK(idx.back() < p.L);
+        }
+        std::cout << "  K=" << K << " S=" << p.S << " H=" << p.H << " L=" << p.L
+                  << " J=" << p.J << " ✓" << std::endl;
+    }
+}
+
+// ============================================================================
+// TEST 2: SISTEMATICO
+// ============================================================================
+void test_systematic() {
+    std::cout << "--- Sistematico ---" << std::endl;
+    AuroraRaptorQ rq;
+    const size_t T = 64;
+    for (size_t size : {1, 100, 1000, 5000}) {
+        auto payload = generate_payload(size, (uint32_t)size);
+        auto syms = rq.encode_all(payload.data(), size, T, 4);
+        const size_t K = (size + T - 1) / T;
+        CHECK(syms.size() == K + 4);
+        for (size_t i = 0; i < K; ++i) {
+            CHECK(syms[i].esi == i);
+            size_t n = std::min(T, size - i * T);
+            CHECK(std::equal(payload.begin() + i * T, payload.begin() + i * T + n, syms[i].bytes.begin()));
+        }
+        auto dec = rq.make_decoder(size, T);
+        for (size_t i = 0; i < K; ++i) dec->add(syms[i]);
+        CHECK(dec->ready());
+        auto out = dec->decode();
+        CHECK(out && *out == payload);
+        std::cout << "  size=" << size << " K=" << K << " ✓" << std::endl;
+    }
+}
+
+// ============================================================================
+// TEST 3: PERDITE CASUALI
+// ============================================================================
+void test_random_loss() {
+    std::cout << "--- Perdite casuali ---" << std::endl;
+    AuroraRaptorQ rq;
+    const size_t T = 32;
+    std::mt19937 rng(3);
+    for (size_t size : {300, 3200, 32000}) {
+        auto payload = generate_payload(size, (uint32_t)size + 1);
+        const uint32_t K = (uint32_t)((size + T - 1) / T);
+        auto syms = rq.encode_all(payload.data(), size, T, K);
+        std::shuffle(syms.begin(), syms.end(), rng);   // ~50% perdite sui primi simboli
+
+        auto dec = rq.make_decoder(size, T);
+        std::optional<std::vector<uint8_t>> out;
+        for (size_t i = 0; i < syms.size() && !out; ++i) {
+            dec->add(syms[i]);
+            if (dec->ready()) out = dec->decode();
+        }
+        CHECK(out && *out == payload);
+        std::cout << "  size=" << size << " K=" << K << " simboli=" << dec->received() << " ✓" << std::endl;
+    }
+}
+
+// ============================================================================
+// TEST 4: OVERHEAD
+// ============================================================================
+void test_overhead() {
+    std::cout << "--- Overhead di ricezione ---" << std::endl;
+    AuroraRaptorQ rq;
+    const size_t T = 16;
+    for (uint32_t K : {10u, 100u, 400u, 1000u}) {
+        const int trials = 100;
+        int ok_at[3] = {0, 0, 0};
+        for (int t = 0; t < trials; ++t) {
+            auto payload = generate_payload(K * T, 1000u * K + t);
+            auto syms = rq.encode_all(payload.data(), payload.size(), T, K + 8);
+            std::mt19937 rng(t);
+            std::shuffle(syms.begin(), syms.end(), rng);
+            for (int extra = 0; extra < 3; ++extra) {
+                auto dec = rq.make_decoder(payload.size(), T);
+                for (uint32_t i = 0; i < K + (uint32_t)extra; ++i) dec->add(syms[i]);
+                auto out = dec->decode();
+                if (out) { CHECK(*out == payload); ++ok_at[extra]; }
+            }
+        }
+        std::cout << "  K=" << K << " successo K/K+1/K+2: " << ok_at[0] << "/" << ok_at[1] << "/"
+                  << ok_at[2] << " su " << trials << std::endl;
+        CHECK(ok_at[2] >= trials * 98 / 100);
+    }
+    std::cout << "  ✓" << std::endl;
+}
+
+// ============================================================================
+// TEST 5: ADD / READY
+// ============================================================================
+void test_add_ready() {
+    std::cout << "--- add() / ready() ---" << std::endl;
+    AuroraRaptorQ rq;
+    const size_t T = 32, size = 20 * T;
+    auto payload = generate_payload(size, 5);
+    auto syms = rq.encode_all(payload.data(), size, T, 40);
+    auto dec = rq.make_decoder(size, T);
+
+    // solo repair: servono K simboli distinti prima di tentare
+    for (uint32_t i = 0; i < 19; ++i) {
+        bool added = dec->add(syms[20 + i]);
+        CHECK(added);
+    }
+    bool dup = dec->add(syms[20]);                                   // duplicato
+    bool too_long = dec->add(syms[21].esi, syms[21].bytes.data(), T + 1);
+    CHECK(!dup && !too_long);
+    CHECK(!dec->ready());
+    auto early = dec->decode();
+    CHECK(!early);
+
+    dec->add(syms[39]);
+    CHECK(dec->ready());
+    if (!dec->decode()) {
+        CHECK(!dec->ready());     // stesso insieme: nessun nuovo tentativo
+        for (uint32_t i = 40; i < 60 && !dec->ready(); ++i) dec->add(syms[i]);
+        CHECK(dec->ready());
+    }
+    std::optional<std::vector<uint8_t>> out;
+    for (uint32_t i = 40; i < 60 && !out; ++i) {
+        if (dec->ready()) out = dec->decode();
+        if (!out) dec->add(syms[i]);
+    }
+    if (!out) out = dec->decode();
+    CHECK(out && *out == payload);
+    bool late = dec->add(syms[0]);    // dopo la decodifica non accetta altro
+    CHECK(!late);
+    CHECK(dec->ready());
+    auto again = dec->decode();
+    CHECK(again == out);
+    std::cout << "  simboli=" << dec->received() << " ✓" << std::endl;
+}
+
+int main() {
+    std::cout << string(70, '=') << std::endl;
+    std::cout << "TEST CODEC RAPTORQ (aurora::fec)" << std::endl;
+    std::cout << string(70, '=') << std::endl;
+
+    try {
+        test_params();
+        test_systematic();
+        test_random_loss();
+        test_overhead();
+        test_add_ready();
+
+        std::cout << string(70, '=') << std::endl;
+        std::cout << "TUTTI I TEST RAPTORQ COMPLETATI CON SUCCESSO!" << std::endl;
+        std::cout << string(70, '=') << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\nERRORE: " << e.what() << std::endl;
+        return 1;
+    }
+}